@@ -0,0 +1,2133 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 9 "/root/repo/src/sysy.y"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <cstring>
+#include <vector>
+#include "ast.h"
+
+int yylex();
+void yyerror(std::unique_ptr<BaseAST> &ast, const char *s);
+
+using namespace std;
+
+#line 85 "/root/repo/build/sysy.tab.cpp"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "sysy.tab.hpp"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_IFX = 3,                        /* IFX  */
+  YYSYMBOL_RETURN = 4,                     /* RETURN  */
+  YYSYMBOL_INT = 5,                        /* INT  */
+  YYSYMBOL_VOID = 6,                       /* VOID  */
+  YYSYMBOL_PLUS = 7,                       /* PLUS  */
+  YYSYMBOL_MINUS = 8,                      /* MINUS  */
+  YYSYMBOL_NOT = 9,                        /* NOT  */
+  YYSYMBOL_TIMES = 10,                     /* TIMES  */
+  YYSYMBOL_DIV = 11,                       /* DIV  */
+  YYSYMBOL_MOD = 12,                       /* MOD  */
+  YYSYMBOL_LT = 13,                        /* LT  */
+  YYSYMBOL_GT = 14,                        /* GT  */
+  YYSYMBOL_LE = 15,                        /* LE  */
+  YYSYMBOL_GE = 16,                        /* GE  */
+  YYSYMBOL_EQ = 17,                        /* EQ  */
+  YYSYMBOL_NE = 18,                        /* NE  */
+  YYSYMBOL_AND = 19,                       /* AND  */
+  YYSYMBOL_OR = 20,                        /* OR  */
+  YYSYMBOL_IF = 21,                        /* IF  */
+  YYSYMBOL_ELSE = 22,                      /* ELSE  */
+  YYSYMBOL_WHILE = 23,                     /* WHILE  */
+  YYSYMBOL_BREAK = 24,                     /* BREAK  */
+  YYSYMBOL_CONTINUE = 25,                  /* CONTINUE  */
+  YYSYMBOL_IDENT = 26,                     /* IDENT  */
+  YYSYMBOL_INT_CONST = 27,                 /* INT_CONST  */
+  YYSYMBOL_28_ = 28,                       /* '('  */
+  YYSYMBOL_29_ = 29,                       /* ')'  */
+  YYSYMBOL_30_ = 30,                       /* ','  */
+  YYSYMBOL_31_ = 31,                       /* '{'  */
+  YYSYMBOL_32_ = 32,                       /* '}'  */
+  YYSYMBOL_33_ = 33,                       /* ';'  */
+  YYSYMBOL_34_ = 34,                       /* '='  */
+  YYSYMBOL_YYACCEPT = 35,                  /* $accept  */
+  YYSYMBOL_CompUnit = 36,                  /* CompUnit  */
+  YYSYMBOL_FuncDefList = 37,               /* FuncDefList  */
+  YYSYMBOL_FuncDef = 38,                   /* FuncDef  */
+  YYSYMBOL_FuncType = 39,                  /* FuncType  */
+  YYSYMBOL_FuncFParams = 40,               /* FuncFParams  */
+  YYSYMBOL_FuncFParam = 41,                /* FuncFParam  */
+  YYSYMBOL_Block = 42,                     /* Block  */
+  YYSYMBOL_StmtList = 43,                  /* StmtList  */
+  YYSYMBOL_Stmt = 44,                      /* Stmt  */
+  YYSYMBOL_WhileStmt = 45,                 /* WhileStmt  */
+  YYSYMBOL_IfStmt = 46,                    /* IfStmt  */
+  YYSYMBOL_VarDecl = 47,                   /* VarDecl  */
+  YYSYMBOL_VarDef = 48,                    /* VarDef  */
+  YYSYMBOL_VarAssign = 49,                 /* VarAssign  */
+  YYSYMBOL_Exp = 50,                       /* Exp  */
+  YYSYMBOL_LOrExp = 51,                    /* LOrExp  */
+  YYSYMBOL_LAndExp = 52,                   /* LAndExp  */
+  YYSYMBOL_EqExp = 53,                     /* EqExp  */
+  YYSYMBOL_RelExp = 54,                    /* RelExp  */
+  YYSYMBOL_AddExp = 55,                    /* AddExp  */
+  YYSYMBOL_MulExp = 56,                    /* MulExp  */
+  YYSYMBOL_UnaryExp = 57,                  /* UnaryExp  */
+  YYSYMBOL_FuncCall = 58,                  /* FuncCall  */
+  YYSYMBOL_ExpList = 59,                   /* ExpList  */
+  YYSYMBOL_UnaryOp = 60,                   /* UnaryOp  */
+  YYSYMBOL_PrimaryExp = 61,                /* PrimaryExp  */
+  YYSYMBOL_Number = 62                     /* Number  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  7
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   121
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  35
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  28
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  65
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  114
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   282
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+      28,    29,     2,     2,    30,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    33,
+       2,    34,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    31,     2,    32,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,    55,    55,    63,    68,    76,    87,    91,    98,   102,
+     107,   115,   124,   132,   136,   144,   153,   162,   168,   174,
+     180,   186,   192,   198,   204,   209,   217,   227,   235,   246,
+     253,   262,   274,   282,   288,   298,   304,   314,   320,   328,
+     339,   345,   353,   361,   369,   380,   386,   394,   405,   411,
+     419,   427,   438,   444,   451,   460,   466,   475,   480,   488,
+     492,   496,   503,   509,   515,   527
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "IFX", "RETURN", "INT",
+  "VOID", "PLUS", "MINUS", "NOT", "TIMES", "DIV", "MOD", "LT", "GT", "LE",
+  "GE", "EQ", "NE", "AND", "OR", "IF", "ELSE", "WHILE", "BREAK",
+  "CONTINUE", "IDENT", "INT_CONST", "'('", "')'", "','", "'{'", "'}'",
+  "';'", "'='", "$accept", "CompUnit", "FuncDefList", "FuncDef",
+  "FuncType", "FuncFParams", "FuncFParam", "Block", "StmtList", "Stmt",
+  "WhileStmt", "IfStmt", "VarDecl", "VarDef", "VarAssign", "Exp", "LOrExp",
+  "LAndExp", "EqExp", "RelExp", "AddExp", "MulExp", "UnaryExp", "FuncCall",
+  "ExpList", "UnaryOp", "PrimaryExp", "Number", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-97)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int8 yypact[] =
+{
+      14,   -97,   -97,    17,    14,   -97,    20,   -97,   -97,   -20,
+      38,    50,    10,   -97,   -97,    55,    38,   -97,   -97,   -97,
+      40,    -5,    63,   -97,   -97,   -97,    60,    64,    57,    66,
+     -16,   -97,     6,   -97,   -97,   -97,   -97,   -97,   -97,    67,
+      69,    71,    85,    87,    18,    37,    62,    48,   -97,   -97,
+       6,   -97,   -97,    79,   -97,    75,    76,   -97,     6,     6,
+     -97,   -97,    -2,     6,    80,   -97,   -97,   -97,     6,     6,
+       6,     6,     6,     6,     6,     6,     6,     6,     6,     6,
+       6,   -97,   -97,     6,    82,    83,   -97,   -97,    51,   -97,
+     -97,    87,    18,    37,    37,    62,    62,    62,    62,    48,
+      48,   -97,   -97,   -97,   -97,    70,    70,   -97,     6,    91,
+     -97,   -97,    70,   -97
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       0,     6,     7,     0,     2,     3,     0,     1,     4,     0,
+       8,     0,     0,    10,    11,     0,     0,    13,     5,     9,
+       0,     0,     0,    59,    60,    61,     0,     0,     0,     0,
+      64,    65,     0,    12,    21,    20,    14,    23,    22,     0,
+       0,     0,    32,    33,    35,    37,    40,    45,    48,    54,
+       0,    52,    63,    64,    15,     0,     0,    29,     0,     0,
+      24,    25,     0,     0,     0,    17,    18,    19,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    53,    16,     0,     0,     0,    56,    58,     0,    31,
+      62,    34,    36,    38,    39,    41,    42,    43,    44,    46,
+      47,    49,    50,    51,    30,     0,     0,    55,     0,    27,
+      26,    57,     0,    28
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
+{
+     -97,   -97,   -97,   110,   -97,   -97,    99,   101,   -97,   -96,
+     -97,   -97,   -97,   -97,   -97,   -21,   -97,    49,    52,    12,
+     -18,     8,   -49,   -97,   -97,   -97,   -97,   -97
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int8 yydefgoto[] =
+{
+       0,     3,     4,     5,     6,    12,    13,    35,    20,    36,
+      37,    38,    39,    57,    40,    41,    42,    43,    44,    45,
+      46,    47,    48,    49,    88,    50,    51,    52
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int8 yytable[] =
+{
+      55,    81,    23,    24,    25,    23,    24,    25,    10,   109,
+     110,    64,    62,    23,    24,    25,   113,     7,    63,     1,
+       2,    53,    31,    32,    53,    31,    32,    86,    54,   101,
+     102,   103,    53,    31,    32,    70,    71,    84,    85,    15,
+      16,    87,    89,    11,    21,    22,     9,    23,    24,    25,
+      72,    73,    74,    75,    95,    96,    97,    98,    78,    79,
+      80,    26,   104,    27,    28,    29,    30,    31,    32,    76,
+      77,    17,    33,    34,    21,    22,    14,    23,    24,    25,
+     107,   108,    93,    94,    99,   100,    17,   111,    58,    56,
+      60,    26,    59,    27,    28,    29,    30,    31,    32,    61,
+      65,    17,    66,    34,    67,    68,    69,    62,    82,    90,
+      83,   105,   106,   112,     8,    19,    18,    91,     0,     0,
+       0,    92
+};
+
+static const yytype_int8 yycheck[] =
+{
+      21,    50,     7,     8,     9,     7,     8,     9,    28,   105,
+     106,    32,    28,     7,     8,     9,   112,     0,    34,     5,
+       6,    26,    27,    28,    26,    27,    28,    29,    33,    78,
+      79,    80,    26,    27,    28,    17,    18,    58,    59,    29,
+      30,    62,    63,     5,     4,     5,    26,     7,     8,     9,
+      13,    14,    15,    16,    72,    73,    74,    75,    10,    11,
+      12,    21,    83,    23,    24,    25,    26,    27,    28,     7,
+       8,    31,    32,    33,     4,     5,    26,     7,     8,     9,
+      29,    30,    70,    71,    76,    77,    31,   108,    28,    26,
+      33,    21,    28,    23,    24,    25,    26,    27,    28,    33,
+      33,    31,    33,    33,    33,    20,    19,    28,    33,    29,
+      34,    29,    29,    22,     4,    16,    15,    68,    -1,    -1,
+      -1,    69
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     5,     6,    36,    37,    38,    39,     0,    38,    26,
+      28,     5,    40,    41,    26,    29,    30,    31,    42,    41,
+      43,     4,     5,     7,     8,     9,    21,    23,    24,    25,
+      26,    27,    28,    32,    33,    42,    44,    45,    46,    47,
+      49,    50,    51,    52,    53,    54,    55,    56,    57,    58,
+      60,    61,    62,    26,    33,    50,    26,    48,    28,    28,
+      33,    33,    28,    34,    50,    33,    33,    33,    20,    19,
+      17,    18,    13,    14,    15,    16,     7,     8,    10,    11,
+      12,    57,    33,    34,    50,    50,    29,    50,    59,    50,
+      29,    52,    53,    54,    54,    55,    55,    55,    55,    56,
+      56,    57,    57,    57,    50,    29,    29,    29,    30,    44,
+      44,    50,    22,    44
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    35,    36,    37,    37,    38,    39,    39,    40,    40,
+      40,    41,    42,    43,    43,    44,    44,    44,    44,    44,
+      44,    44,    44,    44,    44,    44,    45,    46,    46,    47,
+      48,    49,    50,    51,    51,    52,    52,    53,    53,    53,
+      54,    54,    54,    54,    54,    55,    55,    55,    56,    56,
+      56,    56,    57,    57,    57,    58,    58,    59,    59,    60,
+      60,    60,    61,    61,    61,    62
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     1,     2,     6,     1,     1,     0,     3,
+       1,     2,     3,     0,     2,     2,     3,     2,     2,     2,
+       1,     1,     1,     1,     2,     2,     5,     5,     7,     2,
+       3,     3,     1,     1,     3,     1,     3,     1,     3,     3,
+       1,     3,     3,     3,     3,     1,     3,     3,     1,     3,
+       3,     3,     1,     2,     1,     4,     3,     3,     1,     1,
+       1,     1,     3,     1,     1,     1
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (ast, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, ast); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, std::unique_ptr<BaseAST> &ast)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (ast);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, std::unique_ptr<BaseAST> &ast)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep, ast);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, std::unique_ptr<BaseAST> &ast)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], ast);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, ast); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, std::unique_ptr<BaseAST> &ast)
+{
+  YY_USE (yyvaluep);
+  YY_USE (ast);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (std::unique_ptr<BaseAST> &ast)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* CompUnit: FuncDefList  */
+#line 55 "/root/repo/src/sysy.y"
+                  {
+        auto comp_unit = make_unique<CompUnitAST>();
+        comp_unit->func_defs = unique_ptr<vector<unique_ptr<BaseAST>>>((yyvsp[0].vec_val));
+        ast = move(comp_unit);
+    }
+#line 1215 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 3: /* FuncDefList: FuncDef  */
+#line 63 "/root/repo/src/sysy.y"
+              {
+        auto vec = new vector<unique_ptr<BaseAST>>();
+        vec->push_back(unique_ptr<BaseAST>((yyvsp[0].ast_val)));
+        (yyval.vec_val) = vec;
+    }
+#line 1225 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 4: /* FuncDefList: FuncDefList FuncDef  */
+#line 68 "/root/repo/src/sysy.y"
+                          {
+        auto vec = (yyvsp[-1].vec_val);
+        vec->push_back(unique_ptr<BaseAST>((yyvsp[0].ast_val)));
+        (yyval.vec_val) = vec;
+    }
+#line 1235 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 5: /* FuncDef: FuncType IDENT '(' FuncFParams ')' Block  */
+#line 76 "/root/repo/src/sysy.y"
+                                               {
+        auto ast = new FuncDefAST();
+        ast->func_type = *unique_ptr<string>((yyvsp[-5].str_val));
+        ast->ident = *unique_ptr<string>((yyvsp[-4].str_val));
+        ast->fparams = unique_ptr<vector<unique_ptr<BaseAST>>>((yyvsp[-2].vec_val));
+        ast->block = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1248 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 6: /* FuncType: INT  */
+#line 87 "/root/repo/src/sysy.y"
+          {
+        string *s = new string("int");
+        (yyval.str_val) = s;
+    }
+#line 1257 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 7: /* FuncType: VOID  */
+#line 91 "/root/repo/src/sysy.y"
+           {
+        string *s = new string("void");
+        (yyval.str_val) = s;
+    }
+#line 1266 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 8: /* FuncFParams: %empty  */
+#line 98 "/root/repo/src/sysy.y"
+      {
+        auto vec = new vector<unique_ptr<BaseAST>>();
+        (yyval.vec_val) = vec;
+    }
+#line 1275 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 9: /* FuncFParams: FuncFParams ',' FuncFParam  */
+#line 102 "/root/repo/src/sysy.y"
+                                 {
+        auto vec = (yyvsp[-2].vec_val);
+        vec->push_back(unique_ptr<BaseAST>((yyvsp[0].ast_val)));
+        (yyval.vec_val) = vec;
+    }
+#line 1285 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 10: /* FuncFParams: FuncFParam  */
+#line 107 "/root/repo/src/sysy.y"
+                 {
+        auto vec = new vector<unique_ptr<BaseAST>>();
+        vec->push_back(unique_ptr<BaseAST>((yyvsp[0].ast_val)));
+        (yyval.vec_val) = vec;
+    }
+#line 1295 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 11: /* FuncFParam: INT IDENT  */
+#line 115 "/root/repo/src/sysy.y"
+                {
+        auto ast = new FuncFParamAST();
+        ast->type = "int";
+        ast->ident = *unique_ptr<string>((yyvsp[0].str_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1306 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 12: /* Block: '{' StmtList '}'  */
+#line 124 "/root/repo/src/sysy.y"
+                       {
+        auto ast = new BlockAST();
+        ast->stmts = unique_ptr<vector<unique_ptr<BaseAST>>>((yyvsp[-1].vec_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1316 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 13: /* StmtList: %empty  */
+#line 132 "/root/repo/src/sysy.y"
+      {
+        auto vec = new vector<unique_ptr<BaseAST>>();
+        (yyval.vec_val) = vec;
+    }
+#line 1325 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 14: /* StmtList: StmtList Stmt  */
+#line 136 "/root/repo/src/sysy.y"
+                    {
+        auto vec =(yyvsp[-1].vec_val);
+        vec->push_back(unique_ptr<BaseAST>((yyvsp[0].ast_val)));
+        (yyval.vec_val) = vec;
+    }
+#line 1335 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 15: /* Stmt: RETURN ';'  */
+#line 144 "/root/repo/src/sysy.y"
+                 {
+        auto ret_ast = new ReturnStmtAST();
+        ret_ast->exp = nullptr; // No expression after return
+
+        auto ast = new StmtAST();
+        ast->type = 1;
+        ast->stmt = unique_ptr<BaseAST>(ret_ast);
+        (yyval.ast_val) = ast;
+    }
+#line 1349 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 16: /* Stmt: RETURN Exp ';'  */
+#line 153 "/root/repo/src/sysy.y"
+                     {
+        auto ret_ast = new ReturnStmtAST();
+        ret_ast->exp = unique_ptr<BaseAST>((yyvsp[-1].ast_val));
+
+        auto ast = new StmtAST();
+        ast->type = 1;
+        ast->stmt = unique_ptr<BaseAST>(ret_ast);
+        (yyval.ast_val) = ast;
+    }
+#line 1363 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 17: /* Stmt: VarDecl ';'  */
+#line 162 "/root/repo/src/sysy.y"
+                  {
+        auto ast = new StmtAST();
+        ast->type = 2;
+        ast->stmt = unique_ptr<BaseAST>((yyvsp[-1].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1374 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 18: /* Stmt: VarAssign ';'  */
+#line 168 "/root/repo/src/sysy.y"
+                    {
+        auto ast = new StmtAST();
+        ast->type = 3;
+        ast->stmt = unique_ptr<BaseAST>((yyvsp[-1].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1385 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 19: /* Stmt: Exp ';'  */
+#line 174 "/root/repo/src/sysy.y"
+              {
+        auto ast = new StmtAST();
+        ast->type = 4;
+        ast->stmt = unique_ptr<BaseAST>((yyvsp[-1].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1396 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 20: /* Stmt: Block  */
+#line 180 "/root/repo/src/sysy.y"
+            {
+        auto ast = new StmtAST();
+        ast->type = 5;
+        ast->stmt = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1407 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 21: /* Stmt: ';'  */
+#line 186 "/root/repo/src/sysy.y"
+          {
+        auto ast = new StmtAST();
+        ast->type = 6; // Empty statement
+        ast->stmt = nullptr;
+        (yyval.ast_val) = ast;
+    }
+#line 1418 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 22: /* Stmt: IfStmt  */
+#line 192 "/root/repo/src/sysy.y"
+             {
+        auto ast = new StmtAST();
+        ast->type = 7;
+        ast->stmt = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1429 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 23: /* Stmt: WhileStmt  */
+#line 198 "/root/repo/src/sysy.y"
+                {
+        auto ast = new StmtAST();
+        ast->type = 8;
+        ast->stmt = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1440 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 24: /* Stmt: BREAK ';'  */
+#line 204 "/root/repo/src/sysy.y"
+                {
+        auto stmt_ast = new StmtAST();
+        stmt_ast->type = 9; // Break statement
+        (yyval.ast_val) = stmt_ast;
+    }
+#line 1450 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 25: /* Stmt: CONTINUE ';'  */
+#line 209 "/root/repo/src/sysy.y"
+                   {
+        auto stmt_ast = new StmtAST();
+        stmt_ast->type = 10; // Continue statement
+        (yyval.ast_val) = stmt_ast;
+    }
+#line 1460 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 26: /* WhileStmt: WHILE '(' Exp ')' Stmt  */
+#line 217 "/root/repo/src/sysy.y"
+                             {
+        auto while_ast = new WhileStmtAST();
+        while_ast->exp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        while_ast->stmt = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+
+        (yyval.ast_val) = while_ast;
+    }
+#line 1472 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 27: /* IfStmt: IF '(' Exp ')' Stmt  */
+#line 227 "/root/repo/src/sysy.y"
+                                    {
+        auto if_ast = new IfStmtAST();
+        if_ast->exp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        if_ast->stmt_then = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        if_ast->stmt_else = nullptr; // No else part
+
+        (yyval.ast_val) = if_ast;
+    }
+#line 1485 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 28: /* IfStmt: IF '(' Exp ')' Stmt ELSE Stmt  */
+#line 235 "/root/repo/src/sysy.y"
+                                    {
+        auto if_ast = new IfStmtAST();
+        if_ast->exp = unique_ptr<BaseAST>((yyvsp[-4].ast_val));
+        if_ast->stmt_then = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        if_ast->stmt_else = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+
+        (yyval.ast_val) = if_ast;
+    }
+#line 1498 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 29: /* VarDecl: INT VarDef  */
+#line 246 "/root/repo/src/sysy.y"
+                 {
+        auto ast = new VarDeclStmtAST();
+        ast->var_def = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1508 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 30: /* VarDef: IDENT '=' Exp  */
+#line 253 "/root/repo/src/sysy.y"
+                    {
+        auto ast = new VarDefAST();
+        ast->ident = *unique_ptr<string>((yyvsp[-2].str_val));
+        ast->exp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1519 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 31: /* VarAssign: IDENT '=' Exp  */
+#line 262 "/root/repo/src/sysy.y"
+                    {
+        auto lval = new LValAST();
+        lval->ident = *unique_ptr<string>((yyvsp[-2].str_val));
+
+        auto ast = new VarAssignStmtAST();
+        ast->lval = unique_ptr<BaseAST>(lval);
+        ast->exp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1533 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 32: /* Exp: LOrExp  */
+#line 274 "/root/repo/src/sysy.y"
+             {
+        auto ast = new ExpAST();
+        ast->lorExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1543 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 33: /* LOrExp: LAndExp  */
+#line 282 "/root/repo/src/sysy.y"
+              {
+        auto ast = new LOrExpAST();
+        ast->type = 1;
+        ast->landExp_lorExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1554 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 34: /* LOrExp: LOrExp OR LAndExp  */
+#line 288 "/root/repo/src/sysy.y"
+                        {
+        auto ast = new LOrExpAST();
+        ast->type = 2;
+        ast->landExp_lorExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->landExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1566 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 35: /* LAndExp: EqExp  */
+#line 298 "/root/repo/src/sysy.y"
+            {
+        auto ast = new LAndExpAST();
+        ast->type = 1;
+        ast->eqExp_landExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1577 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 36: /* LAndExp: LAndExp AND EqExp  */
+#line 304 "/root/repo/src/sysy.y"
+                        {
+        auto ast = new LAndExpAST();
+        ast->type = 2;
+        ast->eqExp_landExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->eqExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1589 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 37: /* EqExp: RelExp  */
+#line 314 "/root/repo/src/sysy.y"
+             {
+        auto ast = new EqExpAST();
+        ast->type = 1;
+        ast->relExp_eqExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1600 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 38: /* EqExp: EqExp EQ RelExp  */
+#line 320 "/root/repo/src/sysy.y"
+                      {
+        auto ast = new EqExpAST();
+        ast->type = 2;
+        ast->eq_op = "==";
+        ast->relExp_eqExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->relExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1613 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 39: /* EqExp: EqExp NE RelExp  */
+#line 328 "/root/repo/src/sysy.y"
+                      {
+        auto ast = new EqExpAST();
+        ast->type = 2;
+        ast->eq_op = "!=";
+        ast->relExp_eqExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->relExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1626 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 40: /* RelExp: AddExp  */
+#line 339 "/root/repo/src/sysy.y"
+             {
+        auto ast = new RelExpAST();
+        ast->type = 1;
+        ast->addExp_relExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1637 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 41: /* RelExp: RelExp LT AddExp  */
+#line 345 "/root/repo/src/sysy.y"
+                       {
+        auto ast = new RelExpAST();
+        ast->type = 2;
+        ast->rel_op = "<";
+        ast->addExp_relExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->addExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1650 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 42: /* RelExp: RelExp GT AddExp  */
+#line 353 "/root/repo/src/sysy.y"
+                       {
+        auto ast = new RelExpAST();
+        ast->type = 2;
+        ast->rel_op = ">";
+        ast->addExp_relExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->addExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1663 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 43: /* RelExp: RelExp LE AddExp  */
+#line 361 "/root/repo/src/sysy.y"
+                       {
+        auto ast = new RelExpAST();
+        ast->type = 2;
+        ast->rel_op = "<=";
+        ast->addExp_relExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->addExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1676 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 44: /* RelExp: RelExp GE AddExp  */
+#line 369 "/root/repo/src/sysy.y"
+                       {
+        auto ast = new RelExpAST();
+        ast->type = 2;
+        ast->rel_op = ">=";
+        ast->addExp_relExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->addExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1689 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 45: /* AddExp: MulExp  */
+#line 380 "/root/repo/src/sysy.y"
+             {
+        auto ast = new AddExpAST();
+        ast->type = 1;
+        ast->mulExp_addExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1700 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 46: /* AddExp: AddExp PLUS MulExp  */
+#line 386 "/root/repo/src/sysy.y"
+                         {
+        auto ast = new AddExpAST();
+        ast->type = 2;
+        ast->add_op = "+";
+        ast->mulExp_addExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->mulExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1713 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 47: /* AddExp: AddExp MINUS MulExp  */
+#line 394 "/root/repo/src/sysy.y"
+                          {
+        auto ast = new AddExpAST();
+        ast->type = 2;
+        ast->add_op = "-";
+        ast->mulExp_addExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->mulExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1726 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 48: /* MulExp: UnaryExp  */
+#line 405 "/root/repo/src/sysy.y"
+               {
+        auto ast = new MulExpAST();
+        ast->type = 1;
+        ast->unaryExp_mulExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1737 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 49: /* MulExp: MulExp TIMES UnaryExp  */
+#line 411 "/root/repo/src/sysy.y"
+                            {
+        auto ast = new MulExpAST();
+        ast->type = 2;
+        ast->mul_op = "*";
+        ast->unaryExp_mulExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->unaryExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1750 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 50: /* MulExp: MulExp DIV UnaryExp  */
+#line 419 "/root/repo/src/sysy.y"
+                          {
+        auto ast = new MulExpAST();
+        ast->type = 2;
+        ast->mul_op = "/";
+        ast->unaryExp_mulExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->unaryExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1763 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 51: /* MulExp: MulExp MOD UnaryExp  */
+#line 427 "/root/repo/src/sysy.y"
+                          {
+        auto ast = new MulExpAST();
+        ast->type = 2;
+        ast->mul_op = "%";
+        ast->unaryExp_mulExp = unique_ptr<BaseAST>((yyvsp[-2].ast_val));
+        ast->unaryExp = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1776 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 52: /* UnaryExp: PrimaryExp  */
+#line 438 "/root/repo/src/sysy.y"
+                 {
+        auto ast = new UnaryExpAST();
+        ast->type = 1;
+        ast->primaryExp_unaryExp_funcCall = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1787 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 53: /* UnaryExp: UnaryOp UnaryExp  */
+#line 444 "/root/repo/src/sysy.y"
+                       {
+        auto ast = new UnaryExpAST();
+        ast->type = 2;
+        ast->unary_op = *unique_ptr<string>((yyvsp[-1].str_val));
+        ast->primaryExp_unaryExp_funcCall = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1799 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 54: /* UnaryExp: FuncCall  */
+#line 451 "/root/repo/src/sysy.y"
+               {
+        auto ast = new UnaryExpAST();
+        ast->type = 3;
+        ast->primaryExp_unaryExp_funcCall = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1810 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 55: /* FuncCall: IDENT '(' ExpList ')'  */
+#line 460 "/root/repo/src/sysy.y"
+                            {
+        auto func_call = new FuncCallAST();
+        func_call->ident = *unique_ptr<string>((yyvsp[-3].str_val));
+        func_call->rparams = unique_ptr<vector<unique_ptr<BaseAST>>>((yyvsp[-1].vec_val));
+        (yyval.ast_val) = func_call;
+    }
+#line 1821 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 56: /* FuncCall: IDENT '(' ')'  */
+#line 466 "/root/repo/src/sysy.y"
+                    {
+        auto func_call = new FuncCallAST();
+        func_call->ident = *unique_ptr<string>((yyvsp[-2].str_val));
+        func_call->rparams = make_unique<vector<unique_ptr<BaseAST>>>();
+        (yyval.ast_val) = func_call;
+    }
+#line 1832 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 57: /* ExpList: ExpList ',' Exp  */
+#line 475 "/root/repo/src/sysy.y"
+                      {
+        auto vec = (yyvsp[-2].vec_val);
+        vec->push_back(unique_ptr<BaseAST>((yyvsp[0].ast_val)));
+        (yyval.vec_val) = vec;
+    }
+#line 1842 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 58: /* ExpList: Exp  */
+#line 480 "/root/repo/src/sysy.y"
+          {
+        auto vec = new vector<unique_ptr<BaseAST>>();
+        vec->push_back(unique_ptr<BaseAST>((yyvsp[0].ast_val)));
+        (yyval.vec_val) = vec;
+    }
+#line 1852 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 59: /* UnaryOp: PLUS  */
+#line 488 "/root/repo/src/sysy.y"
+           {
+        string *op = new string("+");
+        (yyval.str_val) = op;
+     }
+#line 1861 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 60: /* UnaryOp: MINUS  */
+#line 492 "/root/repo/src/sysy.y"
+            {
+        string *op = new string("-");
+        (yyval.str_val) = op;
+     }
+#line 1870 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 61: /* UnaryOp: NOT  */
+#line 496 "/root/repo/src/sysy.y"
+          {
+        string *op = new string("!");
+        (yyval.str_val) = op;
+    }
+#line 1879 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 62: /* PrimaryExp: '(' Exp ')'  */
+#line 503 "/root/repo/src/sysy.y"
+                  {
+        auto ast = new PrimaryExpAST();
+        ast->type = 1;
+        ast->exp_number_lval = unique_ptr<BaseAST>((yyvsp[-1].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1890 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 63: /* PrimaryExp: Number  */
+#line 509 "/root/repo/src/sysy.y"
+             {
+        auto ast = new PrimaryExpAST();
+        ast->type = 2;
+        ast->exp_number_lval = unique_ptr<BaseAST>((yyvsp[0].ast_val));
+        (yyval.ast_val) = ast;
+    }
+#line 1901 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 64: /* PrimaryExp: IDENT  */
+#line 515 "/root/repo/src/sysy.y"
+            {
+        auto lval = new LValAST();
+        lval->ident = *unique_ptr<string>((yyvsp[0].str_val));
+
+        auto ast = new PrimaryExpAST();
+        ast->type = 3;
+        ast->exp_number_lval = unique_ptr<BaseAST>(lval);
+        (yyval.ast_val) = ast;
+    }
+#line 1915 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+  case 65: /* Number: INT_CONST  */
+#line 527 "/root/repo/src/sysy.y"
+                {
+        auto ast = new NumberAST();
+        ast->value = (yyvsp[0].int_val);
+        (yyval.ast_val) = ast;
+    }
+#line 1925 "/root/repo/build/sysy.tab.cpp"
+    break;
+
+
+#line 1929 "/root/repo/build/sysy.tab.cpp"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (ast, YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, ast);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, ast);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (ast, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, ast);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, ast);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 534 "/root/repo/src/sysy.y"
+
+
+void yyerror(unique_ptr<BaseAST> &ast, const char *s) {
+    extern int yylineno;
+    extern char *yytext;
+    int len = strlen(yytext);
+    int i;
+    char buf[512] = {0};
+    for (i=0; i<len; ++i)
+        sprintf(buf, "%s%d ", buf, yytext[i]);
+    fprintf(stderr, "ERROR: %s at symbol '%s' on line %d\n", s, buf, yylineno);
+}
@@ -216,7 +216,9 @@ enum class BinaryOp
   XOR = 13,
   SHL = 14,
   SHR = 15,
-  SAR = 16
+  SAR = 16,
+  CZERO_EQZ = 17, // rhs == 0 ? 0 : lhs, Zicond czero.eqz
+  CZERO_NEZ = 18  // rhs != 0 ? 0 : lhs, Zicond czero.nez
 };
 
 class BinaryValue : public IRValue
@@ -268,6 +270,18 @@ private:
       return "and";
     case BinaryOp::OR:
       return "or";
+    case BinaryOp::XOR:
+      return "xor";
+    case BinaryOp::SHL:
+      return "shl";
+    case BinaryOp::SHR:
+      return "shr";
+    case BinaryOp::SAR:
+      return "sar";
+    case BinaryOp::CZERO_EQZ:
+      return "czero_eqz";
+    case BinaryOp::CZERO_NEZ:
+      return "czero_nez";
     default:
       return "unknown";
     }
@@ -443,6 +457,7 @@ public:
   std::vector<std::unique_ptr<IRValue>> params;
   std::vector<std::unique_ptr<BasicBlock>> bbs; // basic blocks
   int local_var_count = 0;                      // number of local variables
+  int memo_table_size = 0;                      // > 0: results for args in [0, size) are memoized
 
   Function(const std::string &func_name,
            std::unique_ptr<FunctionType> func_type)
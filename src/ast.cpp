@@ -1,9 +1,12 @@
 ﻿//#define DEBUG
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <memory>
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "IR.h"
@@ -23,6 +26,14 @@ std::string get_temp() {
   return oss.str();
 }
 
+// emit `%x = ne value, 0`, the operands of && and || must be 0 or 1 before and/or.
+std::string to_bool(const std::string &value) {
+  auto temp_name = get_temp();
+  current_bb->add_inst(std::make_unique<BinaryValue>(
+      temp_name, BinaryOp::NE, std::make_unique<VarRefValue>(value), std::make_unique<IntergerValue>(0)));
+  return temp_name;
+}
+
 // the counter and the function for %then_xxx, %else_xxx and %if_end_xxx.
 // should inc if_cnt on your own.
 static int if_cnt = 0;
@@ -695,6 +706,9 @@ void WhileStmtAST::to_IR() {
   auto while_entry_name = get_while_entry_temp();
   auto while_body_name = get_while_body_temp();
   auto end_block_name = get_while_end_temp();
+  // save the enclosing loop, break/continue after a nested loop still refer to it.
+  int outer_while = cur_while;
+  int outer_in_while = in_while;
   cur_while = while_cnt;
   inc_while_cnt();
 
@@ -733,7 +747,8 @@ void WhileStmtAST::to_IR() {
   auto jump_inst_body = std::make_unique<JumpValue>(while_entry_name);
   current_bb->add_inst(std::move(jump_inst_body));
   exit_scope(); // exit the while body scope
-  in_while = 0;
+  in_while = outer_in_while;
+  cur_while = outer_while;
 
   // create the end block
   auto end_block = std::make_unique<BasicBlock>(end_block_name);
@@ -741,6 +756,84 @@ void WhileStmtAST::to_IR() {
   current_bb = current_func->bbs.back().get();
 }
 
+// Sethi-Ullman labels of expression subtrees: the number of registers needed to
+// evaluate the subtree, and whether it contains a call (then its order is kept).
+struct ExpNeed {
+  int regs;
+  bool has_call;
+};
+static std::unordered_map<const BaseAST *, ExpNeed> need_cache;
+
+static ExpNeed exp_need(const BaseAST *ast);
+
+// a binary node needs one more register only when both sides need the same number.
+static ExpNeed binary_need(const BaseAST *l, const BaseAST *r) {
+  auto ln = exp_need(l);
+  auto rn = exp_need(r);
+  int regs = ln.regs == rn.regs ? ln.regs + 1 : std::max(ln.regs, rn.regs);
+  return {regs, ln.has_call || rn.has_call};
+}
+
+static ExpNeed exp_need(const BaseAST *ast) {
+  auto it = need_cache.find(ast);
+  if (it != need_cache.end()) {
+    return it->second;
+  }
+  ExpNeed need{1, false};
+  if (auto *e = dynamic_cast<const ExpAST *>(ast)) {
+    need = exp_need(e->lorExp.get());
+  } else if (auto *e = dynamic_cast<const LOrExpAST *>(ast)) {
+    need = e->type == 1 ? exp_need(e->landExp_lorExp.get()) : binary_need(e->landExp_lorExp.get(), e->landExp.get());
+  } else if (auto *e = dynamic_cast<const LAndExpAST *>(ast)) {
+    need = e->type == 1 ? exp_need(e->eqExp_landExp.get()) : binary_need(e->eqExp_landExp.get(), e->eqExp.get());
+  } else if (auto *e = dynamic_cast<const EqExpAST *>(ast)) {
+    need = e->type == 1 ? exp_need(e->relExp_eqExp.get()) : binary_need(e->relExp_eqExp.get(), e->relExp.get());
+  } else if (auto *e = dynamic_cast<const RelExpAST *>(ast)) {
+    need = e->type == 1 ? exp_need(e->addExp_relExp.get()) : binary_need(e->addExp_relExp.get(), e->addExp.get());
+  } else if (auto *e = dynamic_cast<const AddExpAST *>(ast)) {
+    need = e->type == 1 ? exp_need(e->mulExp_addExp.get()) : binary_need(e->mulExp_addExp.get(), e->mulExp.get());
+  } else if (auto *e = dynamic_cast<const MulExpAST *>(ast)) {
+    need = e->type == 1 ? exp_need(e->unaryExp_mulExp.get()) : binary_need(e->unaryExp_mulExp.get(), e->unaryExp.get());
+  } else if (auto *e = dynamic_cast<const UnaryExpAST *>(ast)) {
+    need = exp_need(e->primaryExp_unaryExp_funcCall.get());
+  } else if (auto *e = dynamic_cast<const PrimaryExpAST *>(ast)) {
+    if (e->type == 1) {
+      need = exp_need(e->exp_number_lval.get());
+    }
+  } else if (dynamic_cast<const FuncCallAST *>(ast)) {
+    need.has_call = true;
+  }
+  need_cache[ast] = need;
+  return need;
+}
+
+// evaluate the right operand first when it needs more registers than the left one,
+// so the left result is not held in a register while the right subtree is computed.
+static bool eval_right_first(const BaseAST *l, const BaseAST *r) {
+  auto ln = exp_need(l);
+  auto rn = exp_need(r);
+  return !ln.has_call && !rn.has_call && rn.regs > ln.regs;
+}
+
+// lower both operands of a binary expression in the order chosen by eval_right_first
+// and return {left, right}; as_bool normalizes each side to 0/1 for && and ||.
+template <typename L, typename R>
+static std::pair<std::string, std::string> lower_operands(L *l, R *r, bool as_bool = false) {
+  auto lower = [as_bool](auto *e) {
+    auto value = e->to_IR();
+    return as_bool ? to_bool(value) : value;
+  };
+  std::string left, right;
+  if (eval_right_first(l, r)) {
+    right = lower(r);
+    left = lower(l);
+  } else {
+    left = lower(l);
+    right = lower(r);
+  }
+  return {left, right};
+}
+
 std::string ExpAST::to_IR() {
   // Exp ::= LOrExp
   auto *lor_exp = dynamic_cast<LOrExpAST *>(lorExp.get());
@@ -765,11 +858,9 @@ std::string LOrExpAST::to_IR() {
   } else if (type == 2) {
     // LOrExp "||" LAndExp
     auto *l = dynamic_cast<LOrExpAST *>(landExp_lorExp.get());
-    auto left_temp_name = l->to_IR();
-    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
-
     auto *r = dynamic_cast<LAndExpAST *>(landExp.get());
-    auto right_temp_name = r->to_IR();
+    auto [left_temp_name, right_temp_name] = lower_operands(l, r, true);
+    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
     auto rhs = std::make_unique<VarRefValue>(right_temp_name);
 
     auto temp_name = get_temp();
@@ -791,11 +882,9 @@ std::string LAndExpAST::to_IR() {
   } else if (type == 2) {
     // LAndExp "&&" EqExp
     auto *l = dynamic_cast<LAndExpAST *>(eqExp_landExp.get());
-    auto left_temp_name = l->to_IR();
-    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
-
     auto *r = dynamic_cast<EqExpAST *>(eqExp.get());
-    auto right_temp_name = r->to_IR();
+    auto [left_temp_name, right_temp_name] = lower_operands(l, r, true);
+    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
     auto rhs = std::make_unique<VarRefValue>(right_temp_name);
     auto temp_name = get_temp();
     auto binary_inst = std::make_unique<BinaryValue>(
@@ -816,11 +905,9 @@ std::string EqExpAST::to_IR() {
   } else if (type == 2) {
     // EqExp "==" RelExp
     auto *l = dynamic_cast<EqExpAST *>(relExp_eqExp.get());
-    auto left_temp_name = l->to_IR();
-    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
-
     auto *r = dynamic_cast<RelExpAST *>(relExp.get());
-    auto right_temp_name = r->to_IR();
+    auto [left_temp_name, right_temp_name] = lower_operands(l, r);
+    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
     auto rhs = std::make_unique<VarRefValue>(right_temp_name);
     auto temp_name = get_temp();
     BinaryOp op = (eq_op == "==") ? BinaryOp::EQ : BinaryOp::NE;
@@ -842,11 +929,9 @@ std::string RelExpAST::to_IR() {
   } else if (type == 2) {
     // RelExp "<" AddExp
     auto *l = dynamic_cast<RelExpAST *>(addExp_relExp.get());
-    auto left_temp_name = l->to_IR();
-    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
-
     auto *r = dynamic_cast<AddExpAST *>(addExp.get());
-    auto right_temp_name = r->to_IR();
+    auto [left_temp_name, right_temp_name] = lower_operands(l, r);
+    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
     auto rhs = std::make_unique<VarRefValue>(right_temp_name);
     auto temp_name = get_temp();
     BinaryOp op;
@@ -879,11 +964,9 @@ std::string AddExpAST::to_IR() {
   } else if (type == 2) {
     // AddExp ("+" | "-") MulExp
     auto *l = dynamic_cast<AddExpAST *>(mulExp_addExp.get());
-    auto left_temp_name = l->to_IR();
-    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
-
     auto *r = dynamic_cast<MulExpAST *>(mulExp.get());
-    auto right_temp_name = r->to_IR();
+    auto [left_temp_name, right_temp_name] = lower_operands(l, r);
+    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
     auto rhs = std::make_unique<VarRefValue>(right_temp_name);
     auto temp_name = get_temp();
     BinaryOp op = (add_op == "+") ? BinaryOp::ADD : BinaryOp::SUB;
@@ -907,11 +990,9 @@ std::string MulExpAST::to_IR() {
   } else if (type == 2) {
     // MulExp "*" UnaryExp
     auto *l = dynamic_cast<MulExpAST *>(unaryExp_mulExp.get());
-    auto left_temp_name = l->to_IR();
-    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
-
     auto *r = dynamic_cast<UnaryExpAST *>(unaryExp.get());
-    auto right_temp_name = r->to_IR();
+    auto [left_temp_name, right_temp_name] = lower_operands(l, r);
+    auto lhs = std::make_unique<VarRefValue>(left_temp_name);
     auto rhs = std::make_unique<VarRefValue>(right_temp_name);
 
     auto temp_name = get_temp();
@@ -0,0 +1,252 @@
+#include "callgraph.h"
+#include <algorithm>
+#include <functional>
+#include <unordered_set>
+
+CallGraph build_call_graph(Program* program) {
+    CallGraph cg;
+    int n = program->funcs.size();
+    for (int i = 0; i < n; i++) {
+        cg.functions.push_back(program->funcs[i].get());
+        cg.index[program->funcs[i]->name] = i;
+    }
+    cg.callees.resize(n);
+    cg.calls_unknown.assign(n, false);
+    for (int i = 0; i < n; i++) {
+        for (const auto& bb : cg.functions[i]->bbs) {
+            for (const auto& inst : bb->insts) {
+                auto* call = dynamic_cast<const CallValue*>(inst.get());
+                if (!call) {
+                    continue;
+                }
+                auto it = cg.index.find(call->callee);
+                if (it == cg.index.end()) {
+                    cg.calls_unknown[i] = true;
+                } else if (std::find(cg.callees[i].begin(), cg.callees[i].end(), it->second) ==
+                           cg.callees[i].end()) {
+                    cg.callees[i].push_back(it->second);
+                }
+            }
+        }
+    }
+
+    // Tarjan 算法，分量按完成顺序输出，即被调用者在前
+    std::vector<int> order(n, -1), low(n, 0), stack;
+    std::vector<bool> on_stack(n, false);
+    cg.scc_of.assign(n, -1);
+    int counter = 0;
+    std::function<void(int)> visit = [&](int v) {
+        order[v] = low[v] = counter++;
+        stack.push_back(v);
+        on_stack[v] = true;
+        for (int w : cg.callees[v]) {
+            if (order[w] < 0) {
+                visit(w);
+                low[v] = std::min(low[v], low[w]);
+            } else if (on_stack[w]) {
+                low[v] = std::min(low[v], order[w]);
+            }
+        }
+        if (low[v] == order[v]) {
+            std::vector<int> scc;
+            int w;
+            do {
+                w = stack.back();
+                stack.pop_back();
+                on_stack[w] = false;
+                cg.scc_of[w] = cg.sccs.size();
+                scc.push_back(w);
+            } while (w != v);
+            cg.sccs.push_back(scc);
+        }
+    };
+    for (int i = 0; i < n; i++) {
+        if (order[i] < 0) {
+            visit(i);
+        }
+    }
+    return cg;
+}
+
+std::unordered_map<std::string, FunctionEffects> compute_effects(const CallGraph& cg) {
+    std::unordered_map<std::string, FunctionEffects> effects;
+    for (const auto& scc : cg.sccs) {
+        // 分量内的函数相互调用，副作用相同
+        bool recursive = scc.size() > 1;
+        bool pure = true, terminates = true;
+        for (int f : scc) {
+            if (cg.calls_unknown[f]) {
+                pure = terminates = false;
+            }
+            for (int g : cg.callees[f]) {
+                if (cg.scc_of[g] == cg.scc_of[f]) {
+                    recursive = true;
+                    continue;
+                }
+                const auto& e = effects[cg.functions[g]->name];
+                pure = pure && e.pure;
+                terminates = terminates && e.terminates;
+            }
+
+            // 每个循环都要能证明终止
+            Function* func = cg.functions[f];
+            CFG cfg = build_cfg(func);
+            auto idom = compute_idom(cfg);
+            for (const auto& loop : find_loops(cfg, idom)) {
+                if (!loop_terminates(func, cfg, idom, loop)) {
+                    terminates = false;
+                }
+            }
+        }
+        for (int f : scc) {
+            effects[cg.functions[f]->name] = {pure, terminates && !recursive};
+        }
+    }
+    return effects;
+}
+
+void CallGraphOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        normalize_terminators(func.get());
+    }
+
+    CallGraph cg = build_call_graph(program);
+    effects = compute_effects(cg);
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+
+    // 删除调用后重新构建调用图
+    cg = build_call_graph(program);
+    remove_dead_functions(program, cg);
+}
+
+void CallGraphOptimizer::remove_dead_functions(Program* program, const CallGraph& cg) {
+    auto main_it = cg.index.find("@main");
+    if (main_it == cg.index.end()) {
+        return;
+    }
+    std::vector<bool> reachable(cg.functions.size(), false);
+    std::vector<int> stack = {main_it->second};
+    reachable[main_it->second] = true;
+    while (!stack.empty()) {
+        int f = stack.back();
+        stack.pop_back();
+        for (int g : cg.callees[f]) {
+            if (!reachable[g]) {
+                reachable[g] = true;
+                stack.push_back(g);
+            }
+        }
+    }
+
+    std::unordered_set<const Function*> dead;
+    for (size_t i = 0; i < cg.functions.size(); i++) {
+        if (!reachable[i]) {
+            dead.insert(cg.functions[i]);
+        }
+    }
+    auto& funcs = program->funcs;
+    funcs.erase(std::remove_if(funcs.begin(), funcs.end(),
+                               [&](const std::unique_ptr<Function>& f) { return dead.count(f.get()) > 0; }),
+                funcs.end());
+}
+
+void CallGraphOptimizer::optimize_function(Function* func) {
+    // 变量（alloc 定义）、只在 entry 中 store 一次的变量、临时变量的定义次数，以及所有被使用的名字
+    std::unordered_set<std::string> variables;
+    std::unordered_map<std::string, int> store_count;
+    std::unordered_map<std::string, int> def_count;
+    std::unordered_set<std::string> entry_stores;
+    std::unordered_set<std::string> used;
+    for (size_t b = 0; b < func->bbs.size(); b++) {
+        for (const auto& inst : func->bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::ALLOC) {
+                variables.insert(inst->name);
+            } else if (inst->v_tag == IRValueTag::STORE) {
+                std::string dest = get_def(inst.get());
+                store_count[dest]++;
+                if (b == 0) {
+                    entry_stores.insert(dest);
+                }
+            } else {
+                std::string def = get_def(inst.get());
+                if (!def.empty()) {
+                    def_count[def]++;
+                }
+            }
+            for (auto* op : get_operands(inst.get())) {
+                used.insert((*op)->name);
+            }
+        }
+    }
+
+    // 实参在调用点之间不会改变：常量、参数、只定义一次的临时变量或只赋值一次的变量。
+    // 剥离、尾复制和循环外提会留下多次定义的临时变量，它们在两个调用点之间可能被重新定义
+    auto single_def = [&](const std::string& name) {
+        auto it = def_count.find(name);
+        return it == def_count.end() || it->second == 1;
+    };
+    auto stable = [&](const IRValue* v) {
+        if (v->v_tag == IRValueTag::INTEGER) {
+            return true;
+        }
+        if (!variables.count(v->name)) {
+            return single_def(v->name);
+        }
+        return store_count[v->name] == 1 && entry_stores.count(v->name) > 0;
+    };
+    auto is_pure = [&](const CallValue* call) {
+        auto it = effects.find(call->callee);
+        return it != effects.end() && it->second.pure;
+    };
+    auto key_of = [](const CallValue* call) {
+        std::string key = call->callee + "(";
+        for (const auto& arg : call->args) {
+            key += arg->toString() + ",";
+        }
+        return key + ")";
+    };
+
+    CFG cfg = build_cfg(func);
+    auto idom = compute_idom(cfg);
+
+    // 已出现的纯函数调用：key -> (所在块, 结果名)
+    std::unordered_map<std::string, std::vector<std::pair<int, std::string>>> available;
+    for (size_t b = 0; b < func->bbs.size(); b++) {
+        if (idom[b] < 0) {
+            continue;
+        }
+        auto& insts = func->bbs[b]->insts;
+        for (auto& inst : insts) {
+            auto* call = dynamic_cast<CallValue*>(inst.get());
+            if (!call || !is_pure(call)) {
+                continue;
+            }
+
+            // 结果未被使用且一定返回：删除
+            if (!used.count(call->name) && effects[call->callee].terminates) {
+                inst = nullptr;
+                continue;
+            }
+
+            bool all_stable = std::all_of(call->args.begin(), call->args.end(),
+                                          [&](const auto& arg) { return stable(arg.get()); });
+            if (!all_stable || call->name.empty() || !single_def(call->name)) {
+                continue;
+            }
+            std::string key = key_of(call);
+            auto& prev = available[key];
+            auto it = std::find_if(prev.begin(), prev.end(), [&](const auto& p) {
+                return dominates(idom, p.first, b);
+            });
+            if (it != prev.end()) {
+                // 同一块中先出现的调用，或支配本块的调用
+                inst = std::make_unique<LoadValue>(call->name, std::make_unique<VarRefValue>(it->second));
+            } else {
+                prev.push_back({static_cast<int>(b), call->name});
+            }
+        }
+        insts.erase(std::remove(insts.begin(), insts.end(), nullptr), insts.end());
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef CALLGRAPH_H
+#define CALLGRAPH_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 调用图，以函数在 program->funcs 中的下标表示
+struct CallGraph {
+    std::vector<Function*> functions;
+    std::unordered_map<std::string, int> index;      // 函数名（带 @ 前缀）-> 下标
+    std::vector<std::vector<int>> callees;           // 直接调用的（已定义的）函数，不重复
+    std::vector<bool> calls_unknown;                 // 是否调用了未定义的函数
+    std::vector<std::vector<int>> sccs;              // 强连通分量，被调用者所在的分量排在前面
+    std::vector<int> scc_of;                         // 函数所在的强连通分量
+};
+
+// 函数的副作用
+// ToyC 没有全局变量和指针，函数只能通过返回值影响调用者，
+// 因此只要不调用未知的函数就是纯函数：结果只由实参决定。
+struct FunctionEffects {
+    bool pure = false;        // 无副作用，结果只由实参决定
+    bool terminates = false;  // 一定会返回：不在递归环中，循环都能证明终止，调用的函数也一定返回
+};
+
+CallGraph build_call_graph(Program* program);
+
+// 按强连通分量自底向上推导每个函数的副作用
+std::unordered_map<std::string, FunctionEffects> compute_effects(const CallGraph& cg);
+
+// 基于调用图的优化
+//   1. 删除从 main 不可达的函数；
+//   2. 删除结果未被使用的、一定返回的纯函数调用；
+//   3. 支配范围内实参相同的纯函数调用只计算一次（CSE）。
+class CallGraphOptimizer {
+public:
+    CallGraphOptimizer() = default;
+
+    void optimize(Program* program);
+
+private:
+    // 删除从 main 不可达的函数
+    void remove_dead_functions(Program* program, const CallGraph& cg);
+
+    void optimize_function(Function* func);
+
+    std::unordered_map<std::string, FunctionEffects> effects;
+};
+
+#endif // CALLGRAPH_H
@@ -0,0 +1,556 @@
+#include "cfg.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_set>
+
+bool is_terminator(const IRValue* inst) {
+    return inst->v_tag == IRValueTag::BRANCH ||
+           inst->v_tag == IRValueTag::JUMP ||
+           inst->v_tag == IRValueTag::RETURN;
+}
+
+void normalize_terminators(Function* func) {
+    for (size_t i = 0; i < func->bbs.size(); i++) {
+        auto& insts = func->bbs[i]->insts;
+        bool terminated = false;
+        for (size_t j = 0; j < insts.size(); j++) {
+            if (is_terminator(insts[j].get())) {
+                insts.resize(j + 1);
+                terminated = true;
+                break;
+            }
+        }
+        if (!terminated && i + 1 < func->bbs.size()) {
+            insts.push_back(std::make_unique<JumpValue>(func->bbs[i + 1]->name));
+        }
+    }
+}
+
+CFG build_cfg(const Function* func) {
+    CFG cfg;
+    int n = func->bbs.size();
+    cfg.succs.resize(n);
+    cfg.preds.resize(n);
+    for (int i = 0; i < n; i++) {
+        cfg.index[func->bbs[i]->name] = i;
+    }
+
+    auto add_edge = [&](int from, const std::string& to) {
+        auto it = cfg.index.find(to);
+        if (it == cfg.index.end()) {
+            return;
+        }
+        cfg.succs[from].push_back(it->second);
+        cfg.preds[it->second].push_back(from);
+    };
+
+    for (int i = 0; i < n; i++) {
+        const IRValue* term = nullptr;
+        for (const auto& inst : func->bbs[i]->insts) {
+            if (is_terminator(inst.get())) {
+                term = inst.get();
+                break;
+            }
+        }
+
+        if (term == nullptr) {
+            // 没有终结指令，顺序执行到下一个块
+            if (i + 1 < n) {
+                cfg.succs[i].push_back(i + 1);
+                cfg.preds[i + 1].push_back(i);
+            }
+        } else if (term->v_tag == IRValueTag::BRANCH) {
+            auto* br = static_cast<const BranchValue*>(term);
+            add_edge(i, br->true_block);
+            if (br->false_block != br->true_block) {
+                add_edge(i, br->false_block);
+            }
+        } else if (term->v_tag == IRValueTag::JUMP) {
+            add_edge(i, static_cast<const JumpValue*>(term)->target_block);
+        }
+    }
+    return cfg;
+}
+
+// Cooper-Harvey-Kennedy 迭代算法
+std::vector<int> compute_idom(const CFG& cfg) {
+    int n = cfg.succs.size();
+    std::vector<int> idom(n, -1);
+    if (n == 0) {
+        return idom;
+    }
+
+    // 逆后序
+    std::vector<int> order;
+    std::vector<int> rpo_num(n, -1);
+    std::vector<bool> visited(n, false);
+    std::function<void(int)> dfs = [&](int b) {
+        visited[b] = true;
+        for (int s : cfg.succs[b]) {
+            if (!visited[s]) {
+                dfs(s);
+            }
+        }
+        order.push_back(b);
+    };
+    dfs(0);
+    std::reverse(order.begin(), order.end());
+    for (size_t i = 0; i < order.size(); i++) {
+        rpo_num[order[i]] = i;
+    }
+
+    auto intersect = [&](int a, int b) {
+        while (a != b) {
+            while (rpo_num[a] > rpo_num[b]) {
+                a = idom[a];
+            }
+            while (rpo_num[b] > rpo_num[a]) {
+                b = idom[b];
+            }
+        }
+        return a;
+    };
+
+    idom[0] = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < order.size(); i++) {
+            int b = order[i];
+            int new_idom = -1;
+            for (int p : cfg.preds[b]) {
+                if (idom[p] == -1) {
+                    continue;
+                }
+                new_idom = (new_idom == -1) ? p : intersect(p, new_idom);
+            }
+            if (new_idom != idom[b]) {
+                idom[b] = new_idom;
+                changed = true;
+            }
+        }
+    }
+    return idom;
+}
+
+bool dominates(const std::vector<int>& idom, int a, int b) {
+    if (idom[b] == -1) {
+        return false;
+    }
+    while (true) {
+        if (a == b) {
+            return true;
+        }
+        if (b == idom[b]) {
+            return false;
+        }
+        b = idom[b];
+    }
+}
+
+std::vector<Loop> find_loops(const CFG& cfg, const std::vector<int>& idom) {
+    std::vector<Loop> loops;
+    std::unordered_map<int, int> loop_of_header;
+    int n = cfg.succs.size();
+
+    for (int b = 0; b < n; b++) {
+        for (int s : cfg.succs[b]) {
+            if (!dominates(idom, s, b)) {
+                continue;
+            }
+            // b -> s 是回边
+            if (loop_of_header.find(s) == loop_of_header.end()) {
+                loop_of_header[s] = loops.size();
+                Loop loop;
+                loop.header = s;
+                loop.depth = 1;
+                loop.blocks.insert(s);
+                loops.push_back(loop);
+            }
+            Loop& loop = loops[loop_of_header[s]];
+            loop.latches.push_back(b);
+
+            // 从回边源块逆向搜索到循环头
+            std::vector<int> stack;
+            if (loop.blocks.insert(b).second) {
+                stack.push_back(b);
+            }
+            while (!stack.empty()) {
+                int x = stack.back();
+                stack.pop_back();
+                for (int p : cfg.preds[x]) {
+                    if (idom[p] != -1 && loop.blocks.insert(p).second) {
+                        stack.push_back(p);
+                    }
+                }
+            }
+        }
+    }
+
+    for (auto& loop : loops) {
+        loop.depth = 0;
+        for (const auto& other : loops) {
+            if (other.blocks.count(loop.header)) {
+                loop.depth++;
+            }
+        }
+    }
+    std::stable_sort(loops.begin(), loops.end(), [](const Loop& a, const Loop& b) {
+        return a.blocks.size() < b.blocks.size();
+    });
+    return loops;
+}
+
+std::string get_def(const IRValue* inst) {
+    switch (inst->v_tag) {
+        case IRValueTag::ALLOC:
+        case IRValueTag::LOAD:
+        case IRValueTag::BINARY:
+        case IRValueTag::CALL:
+            return inst->name;
+        case IRValueTag::STORE:
+            return static_cast<const StoreValue*>(inst)->dest->name;
+        default:
+            return "";
+    }
+}
+
+std::vector<std::unique_ptr<IRValue>*> get_operands(IRValue* inst) {
+    std::vector<std::unique_ptr<IRValue>*> ops;
+    switch (inst->v_tag) {
+        case IRValueTag::LOAD:
+            ops.push_back(&static_cast<LoadValue*>(inst)->src);
+            break;
+        case IRValueTag::STORE:
+            ops.push_back(&static_cast<StoreValue*>(inst)->value);
+            break;
+        case IRValueTag::BINARY: {
+            auto* bin = static_cast<BinaryValue*>(inst);
+            ops.push_back(&bin->lhs);
+            ops.push_back(&bin->rhs);
+            break;
+        }
+        case IRValueTag::CALL:
+            for (auto& arg : static_cast<CallValue*>(inst)->args) {
+                ops.push_back(&arg);
+            }
+            break;
+        case IRValueTag::RETURN: {
+            auto* ret = static_cast<ReturnValue*>(inst);
+            if (ret->value) {
+                ops.push_back(&ret->value);
+            }
+            break;
+        }
+        case IRValueTag::BRANCH:
+            ops.push_back(&static_cast<BranchValue*>(inst)->cond);
+            break;
+        default:
+            break;
+    }
+    return ops;
+}
+
+std::unique_ptr<IRValue> clone_inst(const IRValue* inst) {
+    switch (inst->v_tag) {
+        case IRValueTag::INTEGER:
+            return std::make_unique<IntergerValue>(static_cast<const IntergerValue*>(inst)->value);
+        case IRValueTag::FUNC_ARG_REF:
+            return std::make_unique<FuncArgRefValue>(
+                static_cast<const FuncArgRefValue*>(inst)->index, inst->name);
+        case IRValueTag::VAR_REF:
+            return std::make_unique<VarRefValue>(inst->name);
+        case IRValueTag::ALLOC:
+            return std::make_unique<AllocValue>(inst->name);
+        case IRValueTag::LOAD: {
+            auto* load = static_cast<const LoadValue*>(inst);
+            return std::make_unique<LoadValue>(load->name, clone_inst(load->src.get()), load->type);
+        }
+        case IRValueTag::STORE: {
+            auto* store = static_cast<const StoreValue*>(inst);
+            return std::make_unique<StoreValue>(clone_inst(store->value.get()),
+                                                clone_inst(store->dest.get()));
+        }
+        case IRValueTag::BINARY: {
+            auto* bin = static_cast<const BinaryValue*>(inst);
+            return std::make_unique<BinaryValue>(bin->name, bin->op, clone_inst(bin->lhs.get()),
+                                                 clone_inst(bin->rhs.get()));
+        }
+        case IRValueTag::BRANCH: {
+            auto* br = static_cast<const BranchValue*>(inst);
+            return std::make_unique<BranchValue>(clone_inst(br->cond.get()), br->true_block,
+                                                 br->false_block);
+        }
+        case IRValueTag::JUMP:
+            return std::make_unique<JumpValue>(static_cast<const JumpValue*>(inst)->target_block);
+        case IRValueTag::CALL: {
+            auto* call = static_cast<const CallValue*>(inst);
+            std::vector<std::unique_ptr<IRValue>> args;
+            for (const auto& arg : call->args) {
+                args.push_back(clone_inst(arg.get()));
+            }
+            // 前端在函数体内调用自身时返回类型可能为空
+            std::unique_ptr<IRType> ret_type;
+            if (!call->type) {
+                ret_type = nullptr;
+            } else if (call->type->isUnit()) {
+                ret_type = std::make_unique<UnitType>();
+            } else {
+                ret_type = std::make_unique<Int32Type>();
+            }
+            return std::make_unique<CallValue>(call->name, call->callee, args, std::move(ret_type));
+        }
+        case IRValueTag::RETURN: {
+            auto* ret = static_cast<const ReturnValue*>(inst);
+            return std::make_unique<ReturnValue>(ret->value ? clone_inst(ret->value.get()) : nullptr);
+        }
+    }
+    return nullptr;
+}
+
+bool remove_unreachable_blocks(Function* func) {
+    CFG cfg = build_cfg(func);
+    int n = func->bbs.size();
+    std::vector<bool> reachable(n, false);
+    std::vector<int> stack;
+    if (n > 0) {
+        reachable[0] = true;
+        stack.push_back(0);
+    }
+    while (!stack.empty()) {
+        int b = stack.back();
+        stack.pop_back();
+        for (int s : cfg.succs[b]) {
+            if (!reachable[s]) {
+                reachable[s] = true;
+                stack.push_back(s);
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<BasicBlock>> kept;
+    for (int i = 0; i < n; i++) {
+        if (reachable[i]) {
+            kept.push_back(std::move(func->bbs[i]));
+        }
+    }
+    bool changed = static_cast<int>(kept.size()) != n;
+    func->bbs = std::move(kept);
+    return changed;
+}
+
+bool is_commutative(BinaryOp op) {
+    return op == BinaryOp::ADD || op == BinaryOp::MUL || op == BinaryOp::AND || op == BinaryOp::OR ||
+           op == BinaryOp::XOR || op == BinaryOp::EQ || op == BinaryOp::NE;
+}
+
+bool is_compare(BinaryOp op) {
+    return op == BinaryOp::EQ || op == BinaryOp::NE || op == BinaryOp::LT ||
+           op == BinaryOp::LE || op == BinaryOp::GT || op == BinaryOp::GE;
+}
+
+BinaryOp negate_compare(BinaryOp op) {
+    switch (op) {
+        case BinaryOp::LT: return BinaryOp::GE;
+        case BinaryOp::GE: return BinaryOp::LT;
+        case BinaryOp::GT: return BinaryOp::LE;
+        case BinaryOp::LE: return BinaryOp::GT;
+        case BinaryOp::EQ: return BinaryOp::NE;
+        case BinaryOp::NE: return BinaryOp::EQ;
+        default: return op;
+    }
+}
+
+BinaryOp swap_compare(BinaryOp op) {
+    switch (op) {
+        case BinaryOp::LT: return BinaryOp::GT;
+        case BinaryOp::GT: return BinaryOp::LT;
+        case BinaryOp::LE: return BinaryOp::GE;
+        case BinaryOp::GE: return BinaryOp::LE;
+        default: return op;
+    }
+}
+
+bool fold_binary_const(BinaryOp op, int lhs, int rhs, int& result) {
+    uint32_t ul = static_cast<uint32_t>(lhs), ur = static_cast<uint32_t>(rhs);
+    switch (op) {
+        case BinaryOp::ADD: result = static_cast<int>(ul + ur); return true;
+        case BinaryOp::SUB: result = static_cast<int>(ul - ur); return true;
+        case BinaryOp::MUL: result = static_cast<int>(ul * ur); return true;
+        case BinaryOp::DIV:
+            if (rhs == 0) return false;
+            result = rhs == -1 ? static_cast<int>(0u - ul) : lhs / rhs;
+            return true;
+        case BinaryOp::MOD:
+            if (rhs == 0) return false;
+            result = rhs == -1 ? 0 : lhs % rhs;
+            return true;
+        case BinaryOp::AND: result = static_cast<int>(ul & ur); return true;
+        case BinaryOp::OR: result = static_cast<int>(ul | ur); return true;
+        case BinaryOp::XOR: result = static_cast<int>(ul ^ ur); return true;
+        case BinaryOp::SHL: result = static_cast<int>(ul << (ur & 31)); return true;
+        case BinaryOp::SHR: result = static_cast<int>(ul >> (ur & 31)); return true;
+        case BinaryOp::SAR: result = lhs >> (ur & 31); return true;
+        case BinaryOp::EQ: result = lhs == rhs; return true;
+        case BinaryOp::NE: result = lhs != rhs; return true;
+        case BinaryOp::LT: result = lhs < rhs; return true;
+        case BinaryOp::LE: result = lhs <= rhs; return true;
+        case BinaryOp::GT: result = lhs > rhs; return true;
+        case BinaryOp::GE: result = lhs >= rhs; return true;
+        case BinaryOp::CZERO_EQZ: result = rhs == 0 ? 0 : lhs; return true;
+        case BinaryOp::CZERO_NEZ: result = rhs != 0 ? 0 : lhs; return true;
+    }
+    return false;
+}
+
+namespace {
+
+// 在块中查找名字的定义（块内最后一个定义）
+const IRValue* find_def(const BasicBlock* bb, const std::string& name) {
+    const IRValue* def = nullptr;
+    for (const auto& inst : bb->insts) {
+        if (inst->v_tag != IRValueTag::STORE && inst->name == name) {
+            def = inst.get();
+        }
+    }
+    return def;
+}
+
+} // namespace
+
+bool loop_terminates(const Function* func, const CFG& cfg, const std::vector<int>& idom, const Loop& loop) {
+    auto& bbs = func->bbs;
+    std::unordered_set<std::string> variables;
+    for (const auto& bb : bbs) {
+        for (const auto& inst : bb->insts) {
+            if (inst->v_tag == IRValueTag::ALLOC) {
+                variables.insert(inst->name);
+            }
+        }
+    }
+    const BasicBlock* header = bbs[loop.header].get();
+    auto* br = dynamic_cast<const BranchValue*>(header->insts.back().get());
+    if (!br || !cfg.index.count(br->true_block) || !cfg.index.count(br->false_block)) {
+        return false;
+    }
+    bool true_stays = loop.blocks.count(cfg.index.at(br->true_block)) > 0;
+    bool false_stays = loop.blocks.count(cfg.index.at(br->false_block)) > 0;
+    if (true_stays == false_stays) {
+        return false;
+    }
+    auto* cmp = dynamic_cast<const BinaryValue*>(find_def(header, br->cond->name));
+    if (!cmp) {
+        return false;
+    }
+    // 统一成“条件成立时继续循环”
+    BinaryOp op = true_stays ? cmp->op : negate_compare(cmp->op);
+
+    // 循环中每个变量的 store
+    std::map<std::string, std::vector<std::pair<int, const StoreValue*>>> stores;
+    std::unordered_set<std::string> loop_defs;
+    for (int b : loop.blocks) {
+        for (const auto& inst : bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::STORE) {
+                stores[get_def(inst.get())].push_back({b, static_cast<const StoreValue*>(inst.get())});
+            } else if (!get_def(inst.get()).empty()) {
+                loop_defs.insert(get_def(inst.get()));
+            }
+        }
+    }
+
+    // 操作数对应的变量：直接引用变量，或循环头中对变量的 load
+    auto var_of = [&](const IRValue* v) -> std::string {
+        if (v->v_tag != IRValueTag::VAR_REF) {
+            return "";
+        }
+        if (variables.count(v->name)) {
+            return v->name;
+        }
+        auto* load = dynamic_cast<const LoadValue*>(find_def(header, v->name));
+        if (load && load->type == 0 && variables.count(load->src->name)) {
+            return load->src->name;
+        }
+        return "";
+    };
+    auto invariant = [&](const IRValue* v) {
+        if (v->v_tag != IRValueTag::VAR_REF) {
+            return true;
+        }
+        std::string var = var_of(v);
+        if (!var.empty()) {
+            return stores.count(var) == 0;
+        }
+        return loop_defs.count(v->name) == 0;
+    };
+
+    const IRValue* lhs = cmp->lhs.get();
+    const IRValue* rhs = cmp->rhs.get();
+    std::string iv = var_of(lhs);
+    if (iv.empty() || !stores.count(iv)) {
+        std::swap(lhs, rhs);
+        op = swap_compare(op);
+        iv = var_of(lhs);
+    }
+    if (iv.empty() || !stores.count(iv) || !invariant(rhs) || stores[iv].size() != 1) {
+        return false;
+    }
+
+    // iv 唯一的更新必须每轮都执行
+    int update_block = stores[iv][0].first;
+    for (int latch : loop.latches) {
+        if (!dominates(idom, update_block, latch)) {
+            return false;
+        }
+    }
+    const BasicBlock* ub = bbs[update_block].get();
+    auto* next = dynamic_cast<const BinaryValue*>(find_def(ub, stores[iv][0].second->value->name));
+    if (!next || (next->op != BinaryOp::ADD && next->op != BinaryOp::SUB)) {
+        return false;
+    }
+    auto reads_iv = [&](const IRValue* v) {
+        if (v->v_tag != IRValueTag::VAR_REF) {
+            return false;
+        }
+        if (v->name == iv) {
+            return true;
+        }
+        auto* load = dynamic_cast<const LoadValue*>(find_def(ub, v->name));
+        return load && load->type == 0 && load->src->name == iv;
+    };
+    int64_t step;
+    if (reads_iv(next->lhs.get()) && next->rhs->v_tag == IRValueTag::INTEGER) {
+        step = static_cast<const IntergerValue*>(next->rhs.get())->value;
+        if (next->op == BinaryOp::SUB) {
+            step = -step;
+        }
+    } else if (next->op == BinaryOp::ADD && reads_iv(next->rhs.get()) &&
+               next->lhs->v_tag == IRValueTag::INTEGER) {
+        step = static_cast<const IntergerValue*>(next->lhs.get())->value;
+    } else {
+        return false;
+    }
+    if (step == 0) {
+        return false;
+    }
+
+    // 按回绕语义判断：步长为 ±1 时一定先到达边界；常量边界时要求不会越过 INT 的范围
+    bool const_bound = rhs->v_tag == IRValueTag::INTEGER;
+    int64_t bound = const_bound ? static_cast<const IntergerValue*>(rhs)->value : 0;
+    switch (op) {
+        case BinaryOp::LT:
+            return step > 0 && (step == 1 || (const_bound && bound - 1 + step <= INT32_MAX));
+        case BinaryOp::LE:
+            return step > 0 && const_bound && bound + step <= INT32_MAX;
+        case BinaryOp::GT:
+            return step < 0 && (step == -1 || (const_bound && bound + 1 + step >= INT32_MIN));
+        case BinaryOp::GE:
+            return step < 0 && const_bound && bound + step >= INT32_MIN;
+        case BinaryOp::NE:
+            // 奇数步长在模 2^32 下遍历所有值
+            return (step & 1) != 0;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef CFG_H
+#define CFG_H
+
+#include "IR.h"
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 以基本块下标表示的控制流图
+struct CFG {
+    std::vector<std::vector<int>> succs;
+    std::vector<std::vector<int>> preds;
+    std::unordered_map<std::string, int> index;   // 块名（带 % 前缀）-> 下标
+};
+
+// 自然循环
+struct Loop {
+    int header;                 // 循环头
+    std::vector<int> latches;   // 回边的源块
+    std::set<int> blocks;       // 循环包含的所有块（含循环头）
+    int depth;                  // 嵌套深度，最外层为 1
+};
+
+// 是否为终结指令（br / jump / ret）
+bool is_terminator(const IRValue* inst);
+
+// 规范化终结指令：删除第一条终结指令之后的死代码，
+// 并为没有终结指令的块补上跳转到下一个块的 jump，使块的顺序不再影响语义
+void normalize_terminators(Function* func);
+
+// 构建控制流图，以块中第一条终结指令为准
+CFG build_cfg(const Function* func);
+
+// 计算立即支配者，entry 的 idom 为自身，不可达块为 -1
+std::vector<int> compute_idom(const CFG& cfg);
+
+// a 是否支配 b
+bool dominates(const std::vector<int>& idom, int a, int b);
+
+// 查找所有自然循环，内层循环排在前面
+std::vector<Loop> find_loops(const CFG& cfg, const std::vector<int>& idom);
+
+// 指令定义的变量名（store 定义其目标变量），没有则返回空串
+std::string get_def(const IRValue* inst);
+
+// 指令的操作数槽位（不含 store 的目标），可以直接替换其中的值
+std::vector<std::unique_ptr<IRValue>*> get_operands(IRValue* inst);
+
+// 深拷贝一条指令或一个操作数
+std::unique_ptr<IRValue> clone_inst(const IRValue* inst);
+
+// 是否满足交换律
+bool is_commutative(BinaryOp op);
+
+// 是否为比较运算
+bool is_compare(BinaryOp op);
+
+// 比较运算取反（a < b => a >= b），非比较运算原样返回
+BinaryOp negate_compare(BinaryOp op);
+
+// 交换比较运算的两个操作数后的运算（a < b => b > a），其余运算原样返回
+BinaryOp swap_compare(BinaryOp op);
+
+// 按 RV32 的回绕语义计算常量二元运算，除数为零时返回 false
+bool fold_binary_const(BinaryOp op, int lhs, int rhs, int& result);
+
+// 删除从 entry 不可达的基本块，返回是否有删除
+bool remove_unreachable_blocks(Function* func);
+
+// 循环是否一定终止：循环头的退出条件为 iv op bound，
+// iv 每轮恰好以非零常量步长更新一次，且步长方向使 iv 必然到达边界
+bool loop_terminates(const Function* func, const CFG& cfg, const std::vector<int>& idom, const Loop& loop);
+
+#endif // CFG_H
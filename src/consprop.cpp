@@ -1,6 +1,9 @@
 #include "consprop.h"
+#include "cfg.h"
+#include <algorithm>
 #include <memory>
 #include <queue>
+#include <unordered_set>
 using namespace std;
 
 struct ConstVal
@@ -27,6 +30,8 @@ void ConstantPropagationOptimizer::optimize(Program *program)
 
 void ConstantPropagationOptimizer::optimize_function(Function *func)
 {
+    normalize_terminators(func);
+
     unordered_map<string, int> bb_index;
     for (int i = 0; i < (int)func->bbs.size(); ++i)
         bb_index[func->bbs[i]->get_name()] = i;
@@ -76,6 +81,8 @@ void ConstantPropagationOptimizer::optimize_function(Function *func)
 
     queue<int> q;
     vector<bool> in_queue(n, false);
+    // 尚未处理过的前驱不参与 meet，避免循环头在第一次处理时就被判为非常量
+    vector<bool> visited(n, false);
     for (int i = 0; i < n; ++i)
     {
         q.push(i);
@@ -160,13 +167,23 @@ void ConstantPropagationOptimizer::optimize_function(Function *func)
         int b = q.front();
         q.pop();
         in_queue[b] = false;
+        // entry 之外的块在有前驱处理过之前保持为 TOP，不处理
         unordered_map<string, ConstVal> new_in;
-        if (!preds[b].empty())
+        bool first = true;
+        for (int p : preds[b])
         {
-            new_in = OUT[preds[b][0]];
-            for (size_t i = 1; i < preds[b].size(); ++i)
+            if (b == 0)
+                break;
+            if (!visited[p])
+                continue;
+            if (first)
             {
-                int p = preds[b][i];
+                new_in = OUT[p];
+                first = false;
+            }
+            else
+            {
+                // 任一处理过的前驱中没有的名字都是非常量
                 for (auto &[key, val] : new_in)
                 {
                     auto it = OUT[p].find(key);
@@ -177,10 +194,27 @@ void ConstantPropagationOptimizer::optimize_function(Function *func)
                 }
             }
         }
+        if (b != 0 && first)
+            continue;
+        // 第一次处理之后 IN 只能下降：与原来的 IN 再做一次 meet
+        if (visited[b])
+        {
+            for (auto &[key, val] : new_in)
+            {
+                auto it = IN[b].find(key);
+                if (it != IN[b].end())
+                    val = meet_val(val, it->second);
+                else
+                    val = {false, 0};
+            }
+        }
+        for (auto it = new_in.begin(); it != new_in.end();)
+            it = it->second.is_const ? next(it) : new_in.erase(it);
         IN[b] = new_in;
         auto new_out = transfer(IN[b], b);
-        if (new_out != OUT[b])
+        if (!visited[b] || new_out != OUT[b])
         {
+            visited[b] = true;
             OUT[b] = new_out;
             for (int s : succs[b])
                 if (!in_queue[s])
@@ -257,12 +291,11 @@ void ConstantPropagationOptimizer::optimize_function(Function *func)
         }
     };
 
-    vector<bool> alive(n, true);
+    // 被折叠的定义先替换成 li，若其它块仍引用该名字则保留
+    unordered_set<IRValue *> folded;
 
     for (int b = 0; b < n; ++b)
     {
-        if (!alive[b])
-            continue;
         auto env = IN[b];
         vector<unique_ptr<IRValue>> new_insts;
 
@@ -280,6 +313,8 @@ void ConstantPropagationOptimizer::optimize_function(Function *func)
                 if (fold_binary(bin, res))
                 {
                     env[bin->name] = {true, res};
+                    new_insts.push_back(make_unique<LoadValue>(bin->name, make_unique<IntergerValue>(res), 1));
+                    folded.insert(new_insts.back().get());
                     continue;
                 }
                 env.erase(bin->name);
@@ -303,6 +338,8 @@ void ConstantPropagationOptimizer::optimize_function(Function *func)
                 if (get_const(env, ld->src.get(), v))
                 {
                     env[ld->name] = {true, v};
+                    new_insts.push_back(make_unique<LoadValue>(ld->name, make_unique<IntergerValue>(v), 1));
+                    folded.insert(new_insts.back().get());
                     continue;
                 }
                 env.erase(ld->name);
@@ -316,15 +353,9 @@ void ConstantPropagationOptimizer::optimize_function(Function *func)
                 if (get_const(env, br->cond.get(), cond))
                 {
                     if (cond)
-                    {
                         new_insts.push_back(make_unique<JumpValue>(br->true_block));
-                        alive[bb_index[br->false_block.substr(1)]] = false;
-                    }
                     else
-                    {
                         new_insts.push_back(make_unique<JumpValue>(br->false_block));
-                        alive[bb_index[br->true_block.substr(1)]] = false;
-                    }
                 }
                 else
                     new_insts.push_back(move(inst));
@@ -339,11 +370,21 @@ void ConstantPropagationOptimizer::optimize_function(Function *func)
         func->bbs[b]->insts = move(new_insts);
     }
 
-    vector<unique_ptr<BasicBlock>> new_bbs;
-    for (int i = 0; i < n; ++i)
-        if (alive[i])
-            new_bbs.push_back(move(func->bbs[i]));
-    func->bbs = move(new_bbs);
+    // 分支折叠后按可达性删除基本块（未走的分支目标可能还有其它前驱）
+    remove_unreachable_blocks(func);
+
+    unordered_set<string> used;
+    for (auto &bb : func->bbs)
+        for (auto &inst : bb->insts)
+            for (auto *op : get_operands(inst.get()))
+                used.insert((*op)->name);
+    for (auto &bb : func->bbs)
+    {
+        auto &insts = bb->insts;
+        insts.erase(remove_if(insts.begin(), insts.end(), [&](const unique_ptr<IRValue> &inst)
+                              { return folded.count(inst.get()) && !used.count(inst->name); }),
+                    insts.end());
+    }
 
     // === 新增：清理终结指令之后的死代码 ===
     for (auto &bb : func->bbs)
@@ -369,53 +410,7 @@ bool ConstantPropagationOptimizer::fold_binary(BinaryValue *bin, int &result)
         !get_constant(bin->rhs.get(), rhs_const))
         return false;
 
-    switch (bin->op)
-    {
-    case BinaryOp::ADD:
-        result = lhs_const + rhs_const;
-        return true;
-    case BinaryOp::SUB:
-        result = lhs_const - rhs_const;
-        return true;
-    case BinaryOp::MUL:
-        result = lhs_const * rhs_const;
-        return true;
-    case BinaryOp::DIV:
-        if (rhs_const != 0)
-        {
-            result = lhs_const / rhs_const;
-            return true;
-        }
-        break;
-    case BinaryOp::MOD:
-        if (rhs_const != 0)
-        {
-            result = lhs_const % rhs_const;
-            return true;
-        }
-        break;
-    case BinaryOp::EQ:
-        result = (lhs_const == rhs_const);
-        return true;
-    case BinaryOp::NE:
-        result = (lhs_const != rhs_const);
-        return true;
-    case BinaryOp::LT:
-        result = (lhs_const < rhs_const);
-        return true;
-    case BinaryOp::LE:
-        result = (lhs_const <= rhs_const);
-        return true;
-    case BinaryOp::GT:
-        result = (lhs_const > rhs_const);
-        return true;
-    case BinaryOp::GE:
-        result = (lhs_const >= rhs_const);
-        return true;
-    default:
-        break;
-    }
-    return false;
+    return fold_binary_const(bin->op, lhs_const, rhs_const, result);
 }
 
 bool ConstantPropagationOptimizer::get_constant(IRValue *val, int &out_const)
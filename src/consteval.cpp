@@ -0,0 +1,183 @@
+#include "consteval.h"
+#include "cfg.h"
+#include <algorithm>
+#include <sstream>
+
+ConstEvalOptimizer::ConstEvalOptimizer(long fuel_per_call, long total_fuel, int depth_limit)
+    : fuel_per_call(fuel_per_call), total_fuel(total_fuel), depth_limit(depth_limit), fuel(0) {}
+
+std::string ConstEvalOptimizer::call_key(const std::string& callee, const std::vector<int>& args) {
+    std::ostringstream oss;
+    oss << callee << "(";
+    for (int arg : args) {
+        oss << arg << ",";
+    }
+    oss << ")";
+    return oss.str();
+}
+
+bool ConstEvalOptimizer::evaluate(const Function* func, const std::vector<int>& args, int depth, int& result) {
+    if (depth > depth_limit || args.size() != func->params.size()) {
+        return false;
+    }
+    std::string key = call_key(func->name, args);
+    auto cached = cache.find(key);
+    if (cached != cache.end()) {
+        result = cached->second;
+        return true;
+    }
+
+    // 临时变量和变量都按名字保存当前值
+    std::unordered_map<std::string, int> values;
+    for (size_t i = 0; i < args.size(); i++) {
+        values[func->params[i]->name] = args[i];
+    }
+    std::unordered_map<std::string, size_t> block_index;
+    for (size_t i = 0; i < func->bbs.size(); i++) {
+        block_index[func->bbs[i]->name] = i;
+    }
+
+    auto get = [&](const IRValue* v, int& out) {
+        if (v->v_tag == IRValueTag::INTEGER) {
+            out = static_cast<const IntergerValue*>(v)->value;
+            return true;
+        }
+        auto it = values.find(v->name);
+        if (it == values.end()) {
+            return false;
+        }
+        out = it->second;
+        return true;
+    };
+
+    size_t block = 0;
+    while (block < func->bbs.size()) {
+        const auto& insts = func->bbs[block]->insts;
+        size_t next = block + 1;
+        for (const auto& inst : insts) {
+            if (--fuel < 0) {
+                return false;
+            }
+            int a, b;
+            switch (inst->v_tag) {
+                case IRValueTag::LOAD: {
+                    auto* load = static_cast<const LoadValue*>(inst.get());
+                    if (!get(load->src.get(), a)) return false;
+                    values[load->name] = a;
+                    break;
+                }
+                case IRValueTag::STORE: {
+                    auto* store = static_cast<const StoreValue*>(inst.get());
+                    if (!get(store->value.get(), a)) return false;
+                    values[store->dest->name] = a;
+                    break;
+                }
+                case IRValueTag::BINARY: {
+                    auto* bin = static_cast<const BinaryValue*>(inst.get());
+                    int r;
+                    if (!get(bin->lhs.get(), a) || !get(bin->rhs.get(), b) || !fold_binary_const(bin->op, a, b, r)) {
+                        return false;
+                    }
+                    values[bin->name] = r;
+                    break;
+                }
+                case IRValueTag::CALL: {
+                    auto* call = static_cast<const CallValue*>(inst.get());
+                    auto callee = function_map.find(call->callee);
+                    if (callee == function_map.end()) {
+                        return false;
+                    }
+                    std::vector<int> call_args;
+                    for (const auto& arg : call->args) {
+                        if (!get(arg.get(), a)) return false;
+                        call_args.push_back(a);
+                    }
+                    int r;
+                    if (!evaluate(callee->second, call_args, depth + 1, r)) {
+                        return false;
+                    }
+                    if (!call->name.empty()) {
+                        values[call->name] = r;
+                    }
+                    break;
+                }
+                case IRValueTag::RETURN: {
+                    auto* ret = static_cast<const ReturnValue*>(inst.get());
+                    result = 0;
+                    if (ret->value && !get(ret->value.get(), result)) {
+                        return false;
+                    }
+                    cache[key] = result;
+                    return true;
+                }
+                case IRValueTag::BRANCH: {
+                    auto* br = static_cast<const BranchValue*>(inst.get());
+                    if (!get(br->cond.get(), a)) return false;
+                    next = block_index.at(a ? br->true_block : br->false_block);
+                    break;
+                }
+                case IRValueTag::JUMP:
+                    next = block_index.at(static_cast<const JumpValue*>(inst.get())->target_block);
+                    break;
+                default:
+                    break;
+            }
+            if (is_terminator(inst.get())) {
+                break;
+            }
+        }
+        block = next;
+    }
+    // 没有 ret 就执行到了函数末尾
+    return false;
+}
+
+void ConstEvalOptimizer::optimize(Program* program) {
+    function_map.clear();
+    for (auto& func : program->funcs) {
+        normalize_terminators(func.get());
+        function_map[func->name] = func.get();
+    }
+    effects = compute_effects(build_call_graph(program));
+
+    long remaining = total_fuel;
+    for (auto& func : program->funcs) {
+        for (auto& bb : func->bbs) {
+            for (auto& inst : bb->insts) {
+                auto* call = dynamic_cast<CallValue*>(inst.get());
+                if (!call || !effects[call->callee].pure || !function_map.count(call->callee)) {
+                    continue;
+                }
+                std::vector<int> args;
+                bool all_const = true;
+                for (const auto& arg : call->args) {
+                    if (arg->v_tag != IRValueTag::INTEGER) {
+                        all_const = false;
+                        break;
+                    }
+                    args.push_back(static_cast<const IntergerValue*>(arg.get())->value);
+                }
+                if (!all_const || remaining <= 0) {
+                    continue;
+                }
+
+                fuel = std::min(fuel_per_call, remaining);
+                long before = fuel;
+                int result;
+                bool ok = evaluate(function_map[call->callee], args, 0, result);
+                remaining -= before - std::max(fuel, 0L);
+                if (!ok) {
+                    continue;
+                }
+                std::string name = call->name;
+                if (call->type && call->type->isUnit()) {
+                    inst = nullptr; // 纯的 void 函数调用没有任何效果
+                } else {
+                    inst = std::make_unique<LoadValue>(name, std::make_unique<IntergerValue>(result), 1);
+                }
+            }
+            auto& insts = bb->insts;
+            insts.erase(std::remove(insts.begin(), insts.end(), nullptr), insts.end());
+        }
+    }
+}
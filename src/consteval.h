@@ -0,0 +1,40 @@
+#ifndef CONSTEVAL_H
+#define CONSTEVAL_H
+
+#include "IR.h"
+#include "callgraph.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 纯函数调用的编译期求值
+// 实参全是常量的纯函数调用，在编译期用 IR 解释器执行被调函数，把调用替换为结果常量。
+// 执行的指令数受 fuel 限制，递归深度受 depth_limit 限制；
+// 遇到除零、读取未赋值的变量或资源耗尽时放弃，保留原调用。
+class ConstEvalOptimizer {
+public:
+    ConstEvalOptimizer(long fuel_per_call = 100000, long total_fuel = 2000000, int depth_limit = 1000);
+
+    void optimize(Program* program);
+
+private:
+    long fuel_per_call;
+    long total_fuel;
+    int depth_limit;
+
+    // 当前求值剩余的指令数
+    long fuel;
+
+    std::unordered_map<std::string, const Function*> function_map;
+    std::unordered_map<std::string, FunctionEffects> effects;
+
+    // 已求值的调用："@f(1,2)" -> 结果
+    std::unordered_map<std::string, int> cache;
+
+    // 执行 func(args)，成功时把返回值写入 result（void 函数为 0）
+    bool evaluate(const Function* func, const std::vector<int>& args, int depth, int& result);
+
+    static std::string call_key(const std::string& callee, const std::vector<int>& args);
+};
+
+#endif // CONSTEVAL_H
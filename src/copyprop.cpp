@@ -0,0 +1,152 @@
+#include "copyprop.h"
+#include <algorithm>
+
+void CopyPropagationOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+void CopyPropagationOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+    remove_unreachable_blocks(func);
+
+    auto& bbs = func->bbs;
+    int n = bbs.size();
+    CFG cfg = build_cfg(func);
+    auto idom = compute_idom(cfg);
+    auto loops = find_loops(cfg, idom);
+    std::vector<int> depth(n, 0);
+    for (const auto& loop : loops) {
+        for (int b : loop.blocks) {
+            depth[b] = std::max(depth[b], loop.depth);
+        }
+    }
+
+    std::unordered_set<std::string> variables;
+    std::unordered_map<std::string, int> def_count;
+    std::unordered_map<std::string, std::unordered_set<int>> used_in;
+    for (int b = 0; b < n; b++) {
+        for (const auto& inst : bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::ALLOC) {
+                variables.insert(inst->name);
+            }
+            std::string def = get_def(inst.get());
+            if (!def.empty()) {
+                def_count[def]++;
+            }
+            for (auto* op : get_operands(inst.get())) {
+                used_in[(*op)->name].insert(b);
+            }
+        }
+    }
+    auto is_temp = [&](const std::string& name) {
+        return !variables.count(name) && def_count[name] == 1;
+    };
+
+    // 复制的结果 -> 源（常量的名字为 $imm_N）
+    std::unordered_map<std::string, std::unique_ptr<IRValue>> source;
+    // 只在 entry 中 store 一次的变量，entry 中 store 之前的 load 不算
+    std::unordered_set<std::string> fixed;
+    for (int b = 0; b < n; b++) {
+        // 本块中从变量 load 的、所有使用都在本块中的临时变量，以及其后是否 store 过该变量
+        std::unordered_map<std::string, std::string> loaded_from;
+        std::unordered_set<std::string> clobbered;
+        for (const auto& inst : bbs[b]->insts) {
+            for (auto* op : get_operands(inst.get())) {
+                auto it = loaded_from.find((*op)->name);
+                if (it != loaded_from.end() && clobbered.count(it->first)) {
+                    source.erase(it->first);
+                    loaded_from.erase(it);
+                }
+            }
+            if (inst->v_tag == IRValueTag::STORE) {
+                std::string var = get_def(inst.get());
+                if (b == 0 && def_count[var] == 2) {
+                    fixed.insert(var);
+                }
+                for (const auto& [temp, src] : loaded_from) {
+                    if (src == var) {
+                        clobbered.insert(temp);
+                    }
+                }
+                continue;
+            }
+            if (inst->v_tag != IRValueTag::LOAD || !is_temp(inst->name)) {
+                continue;
+            }
+
+            const IRValue* src = static_cast<LoadValue*>(inst.get())->src.get();
+            if (src->v_tag == IRValueTag::INTEGER) {
+                int value = static_cast<const IntergerValue*>(src)->value;
+                bool small = value >= -2048 && value < 2048;
+                bool deeper = false;
+                for (int user : used_in[inst->name]) {
+                    deeper |= depth[user] > depth[b];
+                }
+                if (small || !deeper) {
+                    source[inst->name] = clone_inst(src);
+                }
+            } else if (src->v_tag == IRValueTag::VAR_REF && is_temp(src->name)) {
+                source[inst->name] = clone_inst(src);
+            } else if (src->v_tag == IRValueTag::VAR_REF && variables.count(src->name)) {
+                const auto& users = used_in[inst->name];
+                if (fixed.count(src->name)) {
+                    source[inst->name] = clone_inst(src);
+                } else if (users.size() == 1 && users.count(b)) {
+                    source[inst->name] = clone_inst(src);
+                    loaded_from[inst->name] = src->name;
+                }
+            }
+        }
+    }
+
+    // 复制链经过其它块中的变量读取时不能传播：该变量只在 load 所在的块中未被改写
+    bool dropped = true;
+    while (dropped) {
+        dropped = false;
+        for (auto it = source.begin(); it != source.end(); ++it) {
+            const IRValue* src = it->second.get();
+            auto next = source.find(src->name);
+            if (next == source.end()) {
+                continue;
+            }
+            const std::string& var = next->second->name;
+            if (variables.count(var) && !fixed.count(var)) {
+                source.erase(it);
+                dropped = true;
+                break;
+            }
+        }
+    }
+    if (source.empty()) {
+        return;
+    }
+
+    // 复制链上的最终源
+    auto resolve = [&](const IRValue* v) {
+        for (auto it = source.find(v->name); it != source.end(); it = source.find(v->name)) {
+            v = it->second.get();
+        }
+        return clone_inst(v);
+    };
+    for (auto& bb : bbs) {
+        auto& insts = bb->insts;
+        insts.erase(std::remove_if(insts.begin(), insts.end(), [&](const std::unique_ptr<IRValue>& inst) {
+            return inst->v_tag == IRValueTag::LOAD && source.count(inst->name);
+        }), insts.end());
+        for (auto& inst : insts) {
+            for (auto* op : get_operands(inst.get())) {
+                if (source.count((*op)->name)) {
+                    *op = resolve(op->get());
+                }
+            }
+            if (inst->v_tag == IRValueTag::LOAD) {
+                auto* load = static_cast<LoadValue*>(inst.get());
+                if (load->src->v_tag == IRValueTag::INTEGER) {
+                    load->type = 1;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef COPYPROP_H
+#define COPYPROP_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+// 复制传播与 li 折叠：删除只定义一次的 load 形式的复制，把其使用改为复制的源：
+// 1. li（load 常量）：使用改为立即数；超出 12 位的常量若有使用在更深的循环中则保留 li，
+//    避免在循环中反复生成 lui + addi；
+// 2. 临时变量的复制：使用改为被复制的临时变量；
+// 3. 变量的 load：变量只在 entry 中 store 一次（如参数的副本），
+//    或所有使用都在同一块中且中间没有 store 该变量时，使用改为直接读取该变量。
+class CopyPropagationOptimizer {
+public:
+    CopyPropagationOptimizer() = default;
+
+    void optimize(Program* program);
+
+private:
+    void optimize_function(Function* func);
+};
+
+#endif // COPYPROP_H
@@ -0,0 +1,221 @@
+#include "dce.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <map>
+#include <set>
+
+void DeadCodeEliminationOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+void DeadCodeEliminationOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+    remove_unreachable_blocks(func);
+
+    auto& bbs = func->bbs;
+    int n = bbs.size();
+    CFG cfg = build_cfg(func);
+    auto idom = compute_idom(cfg);
+
+    variables.clear();
+    std::unordered_map<std::string, std::vector<IRValue*>> temp_defs;
+    std::unordered_map<IRValue*, int> block_of;
+    for (int b = 0; b < n; b++) {
+        for (const auto& inst : bbs[b]->insts) {
+            block_of[inst.get()] = b;
+            if (inst->v_tag == IRValueTag::ALLOC) {
+                variables.insert(inst->name);
+            } else if (inst->v_tag != IRValueTag::STORE && !inst->name.empty()) {
+                temp_defs[inst->name].push_back(inst.get());
+            }
+        }
+    }
+
+    // 到达定值分析：每个变量在块入口可能的 store
+    using ReachMap = std::map<std::string, std::set<IRValue*>>;
+    std::vector<ReachMap> in(n), out(n);
+    auto transfer = [&](int b, ReachMap env) {
+        for (const auto& inst : bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::STORE) {
+                env[get_def(inst.get())] = {inst.get()};
+            }
+        }
+        return env;
+    };
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int b = 0; b < n; b++) {
+            ReachMap env;
+            for (int p : cfg.preds[b]) {
+                for (const auto& [var, defs] : out[p]) {
+                    env[var].insert(defs.begin(), defs.end());
+                }
+            }
+            ReachMap new_out = transfer(b, env);
+            in[b] = std::move(env);
+            if (new_out != out[b]) {
+                out[b] = std::move(new_out);
+                changed = true;
+            }
+        }
+    }
+
+    // 每条指令读取的变量能到达的 store
+    std::unordered_map<IRValue*, std::vector<IRValue*>> reaching;
+    for (int b = 0; b < n; b++) {
+        ReachMap env = in[b];
+        for (const auto& inst : bbs[b]->insts) {
+            for (auto* op : get_operands(inst.get())) {
+                if ((*op)->v_tag == IRValueTag::VAR_REF && variables.count((*op)->name)) {
+                    auto& defs = env[(*op)->name];
+                    reaching[inst.get()].insert(reaching[inst.get()].end(), defs.begin(), defs.end());
+                }
+            }
+            if (inst->v_tag == IRValueTag::STORE) {
+                env[get_def(inst.get())] = {inst.get()};
+            }
+        }
+    }
+
+    // 反向 CFG 上的支配树（后支配树），0 号节点为虚拟出口
+    // 到达不了 ret 的块（死循环）也连到虚拟出口
+    auto is_exit = [&](int b) {
+        return bbs[b]->insts.empty() || !is_terminator(bbs[b]->insts.back().get()) ||
+               bbs[b]->insts.back()->v_tag == IRValueTag::RETURN;
+    };
+    std::vector<bool> reaches_exit(n, false);
+    std::vector<int> stack;
+    for (int b = 0; b < n; b++) {
+        if (is_exit(b)) {
+            reaches_exit[b] = true;
+            stack.push_back(b);
+        }
+    }
+    while (!stack.empty()) {
+        int b = stack.back();
+        stack.pop_back();
+        for (int p : cfg.preds[b]) {
+            if (!reaches_exit[p]) {
+                reaches_exit[p] = true;
+                stack.push_back(p);
+            }
+        }
+    }
+    CFG rev;
+    rev.succs.resize(n + 1);
+    rev.preds.resize(n + 1);
+    for (int b = 0; b < n; b++) {
+        if (is_exit(b) || !reaches_exit[b]) {
+            rev.succs[0].push_back(b + 1);
+            rev.preds[b + 1].push_back(0);
+        }
+        for (int s : cfg.succs[b]) {
+            rev.succs[s + 1].push_back(b + 1);
+            rev.preds[b + 1].push_back(s + 1);
+        }
+    }
+    auto ipdom = compute_idom(rev);
+
+    // 控制依赖：块 b 控制依赖于 cdep[b] 中各块的分支（反向支配边界）
+    std::vector<std::vector<int>> cdep(n);
+    for (int x = 1; x <= n; x++) {
+        if (rev.preds[x].size() < 2 || ipdom[x] == -1) {
+            continue;
+        }
+        for (int runner : rev.preds[x]) {
+            while (runner > 0 && runner != ipdom[x]) {
+                cdep[runner - 1].push_back(x - 1);
+                runner = ipdom[runner];
+            }
+        }
+    }
+
+    // 标记活跃
+    std::unordered_set<IRValue*> live;
+    std::vector<IRValue*> worklist;
+    auto mark = [&](IRValue* inst) {
+        if (live.insert(inst).second) {
+            worklist.push_back(inst);
+        }
+    };
+    for (int b = 0; b < n; b++) {
+        for (const auto& inst : bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::RETURN || inst->v_tag == IRValueTag::CALL) {
+                mark(inst.get());
+            }
+        }
+        // 死循环中的块，以及后支配者只有虚拟出口的分支保持原样
+        if (!is_exit(b) && (!reaches_exit[b] || ipdom[b + 1] <= 0)) {
+            mark(bbs[b]->insts.back().get());
+        }
+    }
+    auto loops = find_loops(cfg, idom);
+    for (const auto& loop : loops) {
+        if (loop_terminates(func, cfg, idom, loop)) {
+            continue;
+        }
+        for (int b : loop.blocks) {
+            if (!is_exit(b)) {
+                mark(bbs[b]->insts.back().get());
+            }
+        }
+    }
+
+    std::vector<bool> block_live(n, false);
+    while (!worklist.empty()) {
+        IRValue* inst = worklist.back();
+        worklist.pop_back();
+
+        int b = block_of[inst];
+        if (!block_live[b]) {
+            block_live[b] = true;
+            for (int c : cdep[b]) {
+                if (!is_exit(c)) {
+                    mark(bbs[c]->insts.back().get());
+                }
+            }
+        }
+        for (auto* op : get_operands(inst)) {
+            auto it = temp_defs.find((*op)->name);
+            if ((*op)->v_tag == IRValueTag::VAR_REF && it != temp_defs.end()) {
+                for (IRValue* def : it->second) {
+                    mark(def);
+                }
+            }
+        }
+        for (IRValue* st : reaching[inst]) {
+            mark(st);
+        }
+    }
+
+    // 仍被引用的变量保留 alloc
+    std::unordered_set<std::string> referenced;
+    for (IRValue* inst : live) {
+        if (inst->v_tag == IRValueTag::STORE) {
+            referenced.insert(get_def(inst));
+        }
+        for (auto* op : get_operands(inst)) {
+            referenced.insert((*op)->name);
+        }
+    }
+
+    for (int b = 0; b < n; b++) {
+        auto& insts = bbs[b]->insts;
+        IRValue* term = insts.empty() ? nullptr : insts.back().get();
+        if (term && term->v_tag == IRValueTag::BRANCH && !live.count(term)) {
+            // 死分支直接跳到直接后支配者
+            insts.back() = std::make_unique<JumpValue>(bbs[ipdom[b + 1] - 1]->name);
+        }
+        insts.erase(std::remove_if(insts.begin(), insts.end(), [&](const std::unique_ptr<IRValue>& inst) {
+            if (is_terminator(inst.get()) || live.count(inst.get())) {
+                return false;
+            }
+            return !(inst->v_tag == IRValueTag::ALLOC && referenced.count(inst->name));
+        }), insts.end());
+    }
+    remove_unreachable_blocks(func);
+}
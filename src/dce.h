@@ -0,0 +1,31 @@
+#ifndef DCE_H
+#define DCE_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 激进的死代码删除（ADCE）
+// 先假设所有指令都是死的，从 ret 和 call 出发标记活跃：
+//   1. 活跃指令用到的临时变量，其定义活跃；
+//   2. 活跃指令读取的变量，能到达该处的 store 活跃（其余 store 为死存储）；
+//   3. 活跃指令所在块控制依赖的分支活跃。
+// 未被标记的指令删除，死分支改为跳转到其直接后支配者。
+// 只有能证明会终止的循环才能被整个删除，其余循环的分支一律视为活跃。
+class DeadCodeEliminationOptimizer {
+public:
+    DeadCodeEliminationOptimizer() = default;
+
+    void optimize(Program* program);
+
+private:
+    void optimize_function(Function* func);
+
+    // 当前函数中的变量（alloc 定义）
+    std::unordered_set<std::string> variables;
+};
+
+#endif // DCE_H
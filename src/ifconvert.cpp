@@ -0,0 +1,203 @@
+#include "ifconvert.h"
+#include "rv_lowering.h"
+#include <sstream>
+
+int IfConversionOptimizer::temp_counter = 0;
+
+IfConversionOptimizer::IfConversionOptimizer(int miss_percent, int arm_limit)
+    : miss_percent(miss_percent), arm_limit(arm_limit) {
+}
+
+std::string IfConversionOptimizer::generate_temp_name() {
+    std::ostringstream oss;
+    oss << "%ifconv_" << temp_counter++;
+    return oss.str();
+}
+
+void IfConversionOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        normalize_terminators(func.get());
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            CFG cfg = build_cfg(func.get());
+            for (size_t b = 0; b < func->bbs.size() && !changed; b++) {
+                changed = convert(func.get(), cfg, b);
+            }
+            if (changed) {
+                remove_unreachable_blocks(func.get());
+            }
+        }
+    }
+}
+
+bool IfConversionOptimizer::get_arm(const Function* func, const CFG& cfg, int b, Arm& arm) const {
+    const auto& insts = func->bbs[b]->insts;
+    if (cfg.preds[b].size() != 1 || insts.size() < 2 || static_cast<int>(insts.size()) - 2 > arm_limit) {
+        return false;
+    }
+    auto* jump = dynamic_cast<const JumpValue*>(insts.back().get());
+    auto* store = dynamic_cast<const StoreValue*>(insts[insts.size() - 2].get());
+    if (!jump || !store || store->dest->v_tag != IRValueTag::VAR_REF) {
+        return false;
+    }
+
+    // 其余指令提前执行必须没有副作用，除法留给分支（代价高，也避免除零）
+    const auto& target = current_target();
+    int cost = 0;
+    for (size_t i = 0; i + 2 < insts.size(); i++) {
+        const IRValue* inst = insts[i].get();
+        if (auto* bin = dynamic_cast<const BinaryValue*>(inst)) {
+            if (bin->op == BinaryOp::DIV || bin->op == BinaryOp::MOD) {
+                return false;
+            }
+            cost += bin->op == BinaryOp::MUL ? target.mul : target.alu;
+        } else if (auto* load = dynamic_cast<const LoadValue*>(inst)) {
+            cost += load->type == 1 ? target.alu : 0; // 读变量只是寄存器间的移动
+        } else {
+            return false;
+        }
+    }
+
+    arm.block = b;
+    arm.var = store->dest->name;
+    arm.value = store->value.get();
+    arm.join = jump->target_block;
+    arm.cost = cost;
+    return true;
+}
+
+bool IfConversionOptimizer::convert(Function* func, const CFG& cfg, int head) {
+    auto& head_insts = func->bbs[head]->insts;
+    auto* br = head_insts.empty() ? nullptr : dynamic_cast<BranchValue*>(head_insts.back().get());
+    if (!br || br->true_block == br->false_block) {
+        return false;
+    }
+    int t = cfg.succs[head][0], f = cfg.succs[head][1];
+    if (func->bbs[t]->name != br->true_block) {
+        std::swap(t, f);
+    }
+
+    // 菱形：两边都是分支；三角形：一边是分支，另一边直接到 join
+    Arm arm_t, arm_f;
+    bool has_t = get_arm(func, cfg, t, arm_t);
+    bool has_f = get_arm(func, cfg, f, arm_f);
+    bool diamond = has_t && has_f && arm_t.join == arm_f.join && arm_t.var == arm_f.var;
+    if (!diamond) {
+        if (has_t && arm_t.join == br->false_block) {
+            arm_f = Arm{-1, arm_t.var, nullptr, arm_t.join, 0};
+        } else if (has_f && arm_f.join == br->true_block) {
+            arm_t = Arm{-1, arm_f.var, nullptr, arm_f.join, 0};
+        } else {
+            return false;
+        }
+    }
+
+    // 条件是否已经是 0/1：只定义一次，且定义为比较运算
+    int cond_defs = 0;
+    bool boolean = false;
+    for (const auto& bb : func->bbs) {
+        for (const auto& inst : bb->insts) {
+            if (get_def(inst.get()) == br->cond->name) {
+                auto* bin = dynamic_cast<const BinaryValue*>(inst.get());
+                boolean = bin && is_compare(bin->op);
+                cond_defs++;
+            }
+        }
+    }
+    boolean = boolean && cond_defs == 1;
+
+    auto is_zero = [](const IRValue* v) {
+        return v && v->v_tag == IRValueTag::INTEGER && static_cast<const IntergerValue*>(v)->value == 0;
+    };
+    bool zero_arm = is_zero(arm_t.value) || is_zero(arm_f.value);
+    int select_cost;
+    if (target_has_zicond) {
+        select_cost = zero_arm ? 1 : 3;
+    } else {
+        select_cost = (zero_arm ? 2 : 4) + (boolean ? 0 : 1);
+    }
+
+    // 以半个周期为单位比较
+    const auto& target = current_target();
+    int branchless = 2 * (arm_t.cost + arm_f.cost + select_cost * target.alu);
+    int jumps = diamond ? 2 : 1;
+    int branchy = 2 * target.alu + arm_t.cost + arm_f.cost + jumps * target.alu +
+                  target.branch_miss * miss_percent / 50;
+    if (branchless > branchy) {
+        return false;
+    }
+
+    // 分支中的计算移到 head 的末尾
+    std::vector<std::unique_ptr<IRValue>> hoisted;
+    for (const Arm* arm : {&arm_t, &arm_f}) {
+        if (arm->block < 0) {
+            continue;
+        }
+        auto& insts = func->bbs[arm->block]->insts;
+        for (size_t i = 0; i + 2 < insts.size(); i++) {
+            hoisted.push_back(std::move(insts[i]));
+        }
+        insts.erase(insts.begin(), insts.end() - 2);
+    }
+
+    // 三角形中不赋值的一侧保留变量原来的值
+    auto arm_value = [&](const Arm& arm) -> std::unique_ptr<IRValue> {
+        if (arm.value) {
+            return clone_inst(arm.value);
+        }
+        std::string old = generate_temp_name();
+        hoisted.push_back(std::make_unique<LoadValue>(old, std::make_unique<VarRefValue>(arm.var)));
+        return std::make_unique<VarRefValue>(old);
+    };
+    std::unique_ptr<IRValue> value_t = arm_value(arm_t);
+    std::unique_ptr<IRValue> value_f = arm_value(arm_f);
+
+    auto emit = [&](BinaryOp op, std::unique_ptr<IRValue> lhs, std::unique_ptr<IRValue> rhs) {
+        std::string name = generate_temp_name();
+        hoisted.push_back(std::make_unique<BinaryValue>(name, op, std::move(lhs), std::move(rhs)));
+        return std::make_unique<VarRefValue>(name);
+    };
+    auto cond = [&]() { return clone_inst(br->cond.get()); };
+
+    std::unique_ptr<IRValue> result;
+    if (target_has_zicond) {
+        if (is_zero(value_f.get())) {
+            result = emit(BinaryOp::CZERO_EQZ, std::move(value_t), cond());
+        } else if (is_zero(value_t.get())) {
+            result = emit(BinaryOp::CZERO_NEZ, std::move(value_f), cond());
+        } else {
+            auto kept_t = emit(BinaryOp::CZERO_EQZ, std::move(value_t), cond());
+            auto kept_f = emit(BinaryOp::CZERO_NEZ, std::move(value_f), cond());
+            result = emit(BinaryOp::OR, std::move(kept_t), std::move(kept_f));
+        }
+    } else {
+        std::unique_ptr<IRValue> c = cond();
+        if (!boolean) {
+            c = emit(BinaryOp::NE, std::move(c), std::make_unique<IntergerValue>(0));
+        }
+        if (is_zero(value_f.get())) {
+            // value_t & -c
+            auto mask = emit(BinaryOp::SUB, std::make_unique<IntergerValue>(0), std::move(c));
+            result = emit(BinaryOp::AND, std::move(value_t), std::move(mask));
+        } else if (is_zero(value_t.get())) {
+            // value_f & (c - 1)
+            auto mask = emit(BinaryOp::ADD, std::move(c), std::make_unique<IntergerValue>(-1));
+            result = emit(BinaryOp::AND, std::move(value_f), std::move(mask));
+        } else {
+            // value_f ^ ((value_t ^ value_f) & -c)
+            auto mask = emit(BinaryOp::SUB, std::make_unique<IntergerValue>(0), std::move(c));
+            auto diff = emit(BinaryOp::XOR, std::move(value_t), clone_inst(value_f.get()));
+            auto masked = emit(BinaryOp::AND, std::move(diff), std::move(mask));
+            result = emit(BinaryOp::XOR, std::move(value_f), std::move(masked));
+        }
+    }
+    hoisted.push_back(std::make_unique<StoreValue>(std::move(result), std::make_unique<VarRefValue>(arm_t.var)));
+    hoisted.push_back(std::make_unique<JumpValue>(arm_t.join));
+
+    head_insts.pop_back();
+    for (auto& inst : hoisted) {
+        head_insts.push_back(std::move(inst));
+    }
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef IFCONVERT_H
+#define IFCONVERT_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+
+// if 转换：把只给同一个变量赋值的小菱形（if-else）和三角形（没有 else 的 if）变成无分支的选择序列。
+// 两个分支中的计算提到分支之前执行，再按条件选出要写入的值：
+// 有 Zicond 时用 czero.eqz/czero.nez 加 or，否则用条件生成掩码 m = -c，选择 b ^ ((a ^ b) & m)。
+// 代价模型比较两边的周期数：转换后两个分支都要执行，分支版本则要付出一半的分支指令和
+// miss_percent% 概率的误预测惩罚（见 rv_lowering.h 中的 TargetLatency）。
+class IfConversionOptimizer {
+public:
+    IfConversionOptimizer(int miss_percent = 50, int arm_limit = 4);
+
+    void optimize(Program* program);
+
+private:
+    // 分支中的一条路径：若干计算后给 var 赋值 value，再跳到 join
+    struct Arm {
+        int block = -1;       // -1 表示三角形中直接到达 join 的一侧
+        std::string var;
+        const IRValue* value = nullptr;
+        std::string join;
+        int cost = 0;
+    };
+
+    // 条件为真时分支被误预测的百分比
+    int miss_percent;
+
+    // 每个分支中除 store 和 jump 外的最大指令数
+    int arm_limit;
+
+    // 块 b 是否是只有一个前驱、只做计算并给一个变量赋值的分支
+    bool get_arm(const Function* func, const CFG& cfg, int b, Arm& arm) const;
+
+    // 转换 head 末尾的分支，返回是否转换
+    bool convert(Function* func, const CFG& cfg, int head);
+
+    std::string generate_temp_name();
+
+    static int temp_counter;
+};
+
+#endif // IFCONVERT_H
@@ -1,20 +1,32 @@
 #include "inline.h"
-#include <iostream>
-#include <sstream>
 #include <algorithm>
+#include <sstream>
 
 int InlineOptimizer::temp_counter = 0;
 
-InlineOptimizer::InlineOptimizer(int depth_limit, int size_limit) 
-    : inline_depth_limit(depth_limit), current_depth(0), inline_size_limit(size_limit) {
+InlineOptimizer::InlineOptimizer(int depth_limit, int size_limit, int growth_limit)
+    : inline_depth_limit(depth_limit), inline_size_limit(size_limit), growth_limit(growth_limit) {
+}
+
+std::string InlineOptimizer::generate_temp_name() {
+    std::ostringstream oss;
+    oss << "%inline_" << temp_counter++;
+    return oss.str();
+}
+
+std::string InlineOptimizer::generate_block_name(const Function* func) {
+    std::ostringstream oss;
+    oss << "%" << func->get_func_name() << "_inline_" << temp_counter++;
+    return oss.str();
 }
 
 void InlineOptimizer::optimize(Program* program) {
     // 首先建立函数映射表
     for (auto& func : program->funcs) {
         function_map[func->name] = func.get();
+        normalize_terminators(func.get());
     }
-    
+
     // 对每个函数进行内联优化
     for (auto& func : program->funcs) {
         optimize_function(func.get());
@@ -22,319 +34,234 @@ void InlineOptimizer::optimize(Program* program) {
 }
 
 void InlineOptimizer::optimize_function(Function* func) {
-    // 对每个基本块进行内联优化
-    for (auto& bb : func->bbs) {
-        optimize_basic_block(bb.get());
-    }
-}
+    int budget = growth_limit;
+    bool changed = true;
+    while (changed) {
+        changed = false;
 
-void InlineOptimizer::optimize_basic_block(BasicBlock* bb) {
-    std::vector<std::unique_ptr<IRValue>> new_instructions;
-    
-    for (size_t i = 0; i < bb->insts.size(); ++i) {
-        auto& inst = bb->insts[i];
-        
-        if (inst->v_tag == IRValueTag::CALL) {
-            auto* call = dynamic_cast<CallValue*>(inst.get());
-            if (call) {
-                std::string callee_name = call->callee;
-                auto it = function_map.find(callee_name);
-                
-                if (it != function_map.end() && can_inline_call(call, it->second)) {
-                    // 执行内联，将内联后的指令添加到新指令列表
-                    std::vector<std::unique_ptr<IRValue>> inlined_instructions = 
-                        inline_function_call(call, it->second);
-                    
-                    // 将内联的指令添加到新指令列表
-                    for (auto& inlined_inst : inlined_instructions) {
-                        new_instructions.push_back(std::move(inlined_inst));
-                    }
-                    
-                    // 跳过原来的调用指令
+        // 每个块所在循环的深度
+        CFG cfg = build_cfg(func);
+        auto idom = compute_idom(cfg);
+        std::vector<int> loop_depth(func->bbs.size(), 0);
+        for (const auto& loop : find_loops(cfg, idom)) {
+            for (int b : loop.blocks) {
+                loop_depth[b] = std::max(loop_depth[b], loop.depth);
+            }
+        }
+
+        // 每次内联后块结构改变，重新扫描
+        for (size_t i = 0; i < func->bbs.size() && !changed; i++) {
+            auto& insts = func->bbs[i]->insts;
+            for (size_t j = 0; j < insts.size(); j++) {
+                auto* call = dynamic_cast<CallValue*>(insts[j].get());
+                if (!call) {
+                    continue;
+                }
+                auto it = function_map.find(call->callee);
+                if (it == function_map.end() || it->second == func) {
+                    continue;
+                }
+                const Function* callee = it->second;
+                if (call->args.size() != callee->params.size() || is_recursive(callee)) {
                     continue;
                 }
+                if (call_depth[call] >= inline_depth_limit) {
+                    continue;
+                }
+                int size = calculate_function_size(callee);
+                if (size > budget || !should_inline(call, callee, loop_depth[i])) {
+                    continue;
+                }
+
+                inline_call(func, i, j, callee);
+                budget -= size;
+                changed = true;
+                break;
             }
         }
-        
-        // 保留原指令
-        new_instructions.push_back(std::move(inst));
     }
-    
-    // 替换指令列表
-    bb->insts = std::move(new_instructions);
 }
 
-bool InlineOptimizer::can_inline(const Function* func) const {
-    // 检查函数是否已经内联过（避免递归内联）
-    if (inlined_functions.find(func->name) != inlined_functions.end()) {
-        return false;
-    }
-    
-    // 检查内联深度
-    if (current_depth >= inline_depth_limit) {
-        return false;
-    }
-    
-    // 检查函数大小 - 更严格的大小限制
-    int func_size = calculate_function_size(func);
-    if (func_size > inline_size_limit || func_size <= 0) {
-        return false;
-    }
-    
-    // 检查函数是否有递归调用
+bool InlineOptimizer::is_recursive(const Function* func) const {
     for (const auto& bb : func->bbs) {
         for (const auto& inst : bb->insts) {
-            if (inst->v_tag == IRValueTag::CALL) {
-                const auto* call = dynamic_cast<const CallValue*>(inst.get());
-                if (call && call->callee == func->name) {
-                    return false; // 递归函数不内联
-                }
+            const auto* call = dynamic_cast<const CallValue*>(inst.get());
+            if (call && call->callee == func->name) {
+                return true;
             }
         }
     }
-    
-    // 只内联单基本块的函数
-    if (func->bbs.size() != 1) {
-        return false;
-    }
-    
-    // 只内联简单的函数（最多6条指令）
-    const auto& bb = func->bbs[0];
-    if (bb->insts.size() > 6) {
-        return false;
-    }
-    
-    return true;
+    return false;
 }
 
-bool InlineOptimizer::can_inline_call(const CallValue* call, const Function* callee) const {
-    // 检查被调用函数是否可以内联
-    if (!can_inline(callee)) {
-        return false;
+int InlineOptimizer::calculate_function_size(const Function* func) const {
+    int size = 0;
+    for (const auto& bb : func->bbs) {
+        for (const auto& inst : bb->insts) {
+            if (inst->v_tag != IRValueTag::ALLOC) {
+                size++;
+            }
+        }
     }
-    
-    // 检查参数数量是否匹配
-    if (call->args.size() != callee->params.size()) {
-        return false;
+    return size;
+}
+
+int InlineOptimizer::inline_bonus(const CallValue* call, const Function* callee) const {
+    // 调用本身：call、恢复 ra、保存结果，以及每个实参一次移动
+    int bonus = 3 + static_cast<int>(call->args.size());
+
+    // 常量实参：参数副本的每次使用都可能被常量传播折叠掉
+    std::unordered_set<std::string> const_params;
+    for (size_t i = 0; i < call->args.size(); i++) {
+        if (call->args[i]->v_tag == IRValueTag::INTEGER) {
+            const_params.insert(callee->params[i]->name);
+        }
     }
-    
-    // 只内联最多2个参数的函数
-    if (callee->params.size() > 2) {
-        return false;
+    if (const_params.empty()) {
+        return bonus;
     }
-    
-    // 检查参数是否都是简单的变量引用
-    for (const auto& arg : call->args) {
-        if (arg->v_tag != IRValueTag::VAR_REF && arg->v_tag != IRValueTag::INTEGER) {
-            return false; // 只内联简单参数的函数调用
+    std::unordered_set<std::string> const_copies;
+    for (const auto& inst : callee->bbs[0]->insts) {
+        auto* store = dynamic_cast<const StoreValue*>(inst.get());
+        if (store && const_params.count(store->value->name)) {
+            const_copies.insert(store->dest->name);
         }
     }
-    
-    // 只内联单基本块的函数
-    if (callee->bbs.size() != 1) {
-        return false;
-    }
-    
-    // 检查函数体是否过于复杂
-    const auto& bb = callee->bbs[0];
-    if (bb->insts.size() > 6) { // 最多6条指令
-        return false;
+    for (const auto& bb : callee->bbs) {
+        for (const auto& inst : bb->insts) {
+            for (auto* op : get_operands(inst.get())) {
+                if (const_copies.count((*op)->name)) {
+                    bonus += 2;
+                }
+            }
+        }
     }
-    
-    return true;
+    return bonus;
 }
 
-std::vector<std::unique_ptr<IRValue>> InlineOptimizer::inline_function_call(CallValue* call, Function* callee) {
-    current_depth++;
-    inlined_functions.insert(callee->name);
-    
-    std::vector<std::unique_ptr<IRValue>> inlined_instructions;
-    
-    // 创建参数映射
-    std::vector<std::string> arg_names;
-    for (const auto& arg : call->args) {
-        arg_names.push_back(arg->name);
+bool InlineOptimizer::should_inline(const CallValue* call, const Function* callee, int loop_depth) const {
+    int cost = calculate_function_size(callee) - inline_bonus(call, callee);
+    int threshold = inline_size_limit << std::min(loop_depth, 2);
+    return cost <= threshold;
+}
+
+void InlineOptimizer::inline_call(Function* caller, size_t block_index, size_t inst_index, const Function* callee) {
+    BasicBlock* bb = caller->bbs[block_index].get();
+    auto call_inst = std::move(bb->insts[inst_index]);
+    auto* call = dynamic_cast<CallValue*>(call_inst.get());
+    int depth = call_depth[call] + 1;
+    call_depth.erase(call);
+
+    // 调用之后的指令移到新的后继块
+    auto cont = std::make_unique<BasicBlock>(generate_block_name(caller));
+    for (size_t i = inst_index + 1; i < bb->insts.size(); i++) {
+        cont->add_inst(std::move(bb->insts[i]));
     }
-    
-    // 为内联的函数体创建新的临时变量名
-    std::unordered_map<std::string, std::string> var_mapping;
-    
-    // 复制函数体的指令
+    bb->insts.resize(inst_index);
+
+    // 被调函数中定义的名字和块名都换成新名字，参数换成实参
+    std::unordered_map<std::string, const IRValue*> params;
+    for (size_t i = 0; i < callee->params.size(); i++) {
+        params[callee->params[i]->name] = call->args[i].get();
+    }
+    std::unordered_map<std::string, std::string> names;
+    std::unordered_map<std::string, std::string> blocks;
+    int ret_count = 0;
     for (const auto& callee_bb : callee->bbs) {
+        blocks[callee_bb->name] = generate_block_name(caller);
         for (const auto& inst : callee_bb->insts) {
-            auto new_inst = clone_instruction(inst.get(), var_mapping, arg_names);
-            if (new_inst) {
-                inlined_instructions.push_back(std::move(new_inst));
+            if (inst->v_tag == IRValueTag::RETURN) {
+                if (static_cast<const ReturnValue*>(inst.get())->value) {
+                    ret_count++;
+                }
+            } else if (inst->v_tag != IRValueTag::STORE && !inst->name.empty()) {
+                names[inst->name] = generate_temp_name();
             }
         }
     }
-    
-    // 如果函数有返回值，需要处理返回值
-    if (!call->name.empty() && callee->f_type->return_type->isInt32()) {
-        if (var_mapping.find("%ret_val") != var_mapping.end()) {
-            std::string return_var = call->name;
-            auto load_inst = std::make_unique<LoadValue>(
-                return_var, 
-                std::make_unique<VarRefValue>(var_mapping["%ret_val"]),
-                0
-            );
-            inlined_instructions.push_back(std::move(load_inst));
-        }
+
+    // 多个返回点通过一个变量合并返回值，只有一个时直接赋给调用结果
+    bool use_result = !call->name.empty() && callee->f_type->return_type->isInt32() && ret_count > 0;
+    std::string ret_var;
+    if (use_result && ret_count > 1) {
+        ret_var = generate_temp_name();
+        auto& entry_insts = caller->bbs[0]->insts;
+        entry_insts.insert(entry_insts.begin(), std::make_unique<AllocValue>(ret_var));
+        cont->insts.insert(cont->insts.begin(),
+                           std::make_unique<LoadValue>(call->name, std::make_unique<VarRefValue>(ret_var)));
     }
-    
-    current_depth--;
-    inlined_functions.erase(callee->name);
-    
-    return inlined_instructions;
-}
 
-std::unique_ptr<IRValue> InlineOptimizer::clone_instruction(
-    const IRValue* inst, 
-    std::unordered_map<std::string, std::string>& var_mapping,
-    const std::vector<std::string>& arg_names) {
-    
-    switch (inst->v_tag) {
-        case IRValueTag::ALLOC: {
-            const auto* alloc = dynamic_cast<const AllocValue*>(inst);
-            std::string new_name = generate_temp_name();
-            var_mapping[alloc->name] = new_name;
-            return std::make_unique<AllocValue>(new_name);
+    auto rename = [&](std::unique_ptr<IRValue>& value) {
+        if (value->v_tag == IRValueTag::INTEGER) {
+            return;
         }
-        
-        case IRValueTag::LOAD: {
-            const auto* load = dynamic_cast<const LoadValue*>(inst);
-            std::string new_name = generate_temp_name();
-            var_mapping[load->name] = new_name;
-            
-            std::string new_src = replace_param_reference(load->src->name, arg_names);
-            if (var_mapping.find(new_src) != var_mapping.end()) {
-                new_src = var_mapping[new_src];
-            }
-            
-            return std::make_unique<LoadValue>(
-                new_name,
-                std::make_unique<VarRefValue>(new_src),
-                load->type
-            );
+        auto param = params.find(value->name);
+        if (param != params.end()) {
+            value = clone_inst(param->second);
+            return;
+        }
+        auto name = names.find(value->name);
+        if (name != names.end()) {
+            value = std::make_unique<VarRefValue>(name->second);
         }
-        
-        case IRValueTag::STORE: {
-            const auto* store = dynamic_cast<const StoreValue*>(inst);
-            
-            std::string new_value = replace_param_reference(store->value->name, arg_names);
-            if (var_mapping.find(new_value) != var_mapping.end()) {
-                new_value = var_mapping[new_value];
+    };
+
+    std::vector<std::unique_ptr<BasicBlock>> new_blocks;
+    for (const auto& callee_bb : callee->bbs) {
+        auto new_bb = std::make_unique<BasicBlock>(blocks[callee_bb->name]);
+        bool terminated = false;
+        for (const auto& inst : callee_bb->insts) {
+            if (inst->v_tag == IRValueTag::RETURN) {
+                const auto* ret = static_cast<const ReturnValue*>(inst.get());
+                if (use_result && ret->value) {
+                    auto value = clone_inst(ret->value.get());
+                    rename(value);
+                    if (ret_var.empty()) {
+                        int type = value->v_tag == IRValueTag::INTEGER ? 1 : 0;
+                        new_bb->add_inst(std::make_unique<LoadValue>(call->name, std::move(value), type));
+                    } else {
+                        new_bb->add_inst(std::make_unique<StoreValue>(std::move(value),
+                                                                      std::make_unique<VarRefValue>(ret_var)));
+                    }
+                }
+                new_bb->add_inst(std::make_unique<JumpValue>(cont->name));
+                terminated = true;
+                break;
             }
-            
-            std::string new_dest = replace_param_reference(store->dest->name, arg_names);
-            if (var_mapping.find(new_dest) != var_mapping.end()) {
-                new_dest = var_mapping[new_dest];
+
+            auto new_inst = clone_inst(inst.get());
+            if (new_inst->v_tag == IRValueTag::STORE) {
+                rename(static_cast<StoreValue*>(new_inst.get())->dest);
+            } else if (names.count(new_inst->name)) {
+                new_inst->name = names[new_inst->name];
             }
-            
-            return std::make_unique<StoreValue>(
-                std::make_unique<VarRefValue>(new_value),
-                std::make_unique<VarRefValue>(new_dest)
-            );
-        }
-        
-        case IRValueTag::BINARY: {
-            const auto* binary = dynamic_cast<const BinaryValue*>(inst);
-            std::string new_name = generate_temp_name();
-            var_mapping[binary->name] = new_name;
-            
-            std::string new_lhs = replace_param_reference(binary->lhs->name, arg_names);
-            if (var_mapping.find(new_lhs) != var_mapping.end()) {
-                new_lhs = var_mapping[new_lhs];
+            for (auto* op : get_operands(new_inst.get())) {
+                rename(*op);
             }
-            
-            std::string new_rhs = replace_param_reference(binary->rhs->name, arg_names);
-            if (var_mapping.find(new_rhs) != var_mapping.end()) {
-                new_rhs = var_mapping[new_rhs];
+            if (auto* br = dynamic_cast<BranchValue*>(new_inst.get())) {
+                br->true_block = blocks[br->true_block];
+                br->false_block = blocks[br->false_block];
+            } else if (auto* jump = dynamic_cast<JumpValue*>(new_inst.get())) {
+                jump->target_block = blocks[jump->target_block];
+            } else if (auto* new_call = dynamic_cast<CallValue*>(new_inst.get())) {
+                call_depth[new_call] = depth;
             }
-            
-            return std::make_unique<BinaryValue>(
-                new_name,
-                binary->op,
-                std::make_unique<VarRefValue>(new_lhs),
-                std::make_unique<VarRefValue>(new_rhs)
-            );
-        }
-        
-        case IRValueTag::RETURN: {
-            const auto* ret = dynamic_cast<const ReturnValue*>(inst);
-            if (ret->value) {
-                std::string new_value = replace_param_reference(ret->value->name, arg_names);
-                if (var_mapping.find(new_value) != var_mapping.end()) {
-                    new_value = var_mapping[new_value];
-                }
-                
-                // 将返回值存储到临时变量中
-                std::string ret_var = generate_temp_name();
-                var_mapping["%ret_val"] = ret_var;
-                
-                auto store_ret = std::make_unique<StoreValue>(
-                    std::make_unique<VarRefValue>(new_value),
-                    std::make_unique<VarRefValue>(ret_var)
-                );
-                return store_ret;
+            terminated = is_terminator(new_inst.get());
+            new_bb->add_inst(std::move(new_inst));
+            if (terminated) {
+                break;
             }
-            return nullptr; // void return
         }
-        
-        default:
-            // 其他指令类型暂时不处理
-            return nullptr;
-    }
-}
-
-std::string InlineOptimizer::replace_param_reference(
-    const std::string& param_name, 
-    const std::vector<std::string>& args) {
-    
-    // 检查是否是参数引用（函数参数通常以@开头）
-    if (param_name.find("@") == 0) {
-        // 检查是否是第一个参数（通常包含'a'）
-        if (param_name.find("a") != std::string::npos && args.size() >= 1) {
-            return args[0];
-        }
-        
-        // 检查是否是第二个参数（通常包含'b'）
-        if (param_name.find("b") != std::string::npos && args.size() >= 2) {
-            return args[1];
-        }
-        
-        // 如果没有找到'a'或'b'，按参数索引处理
-        // 参数名格式可能是 "@SYM_TABLE_X_param_name"
-        size_t last_underscore = param_name.find_last_of('_');
-        if (last_underscore != std::string::npos && last_underscore < param_name.length() - 1) {
-            std::string param_base_name = param_name.substr(last_underscore + 1);
-            
-            // 根据参数名确定索引
-            if (param_base_name == "a" && args.size() >= 1) {
-                return args[0];
-            } else if (param_base_name == "b" && args.size() >= 2) {
-                return args[1];
-            }
+        // void 函数的最后一个块可能没有 ret
+        if (!terminated) {
+            new_bb->add_inst(std::make_unique<JumpValue>(cont->name));
         }
+        new_blocks.push_back(std::move(new_bb));
     }
-    
-    return param_name;
-}
-
-std::string InlineOptimizer::generate_temp_name() {
-    std::ostringstream oss;
-    oss << "%inline_" << temp_counter++;
-    return oss.str();
-}
 
-int InlineOptimizer::calculate_function_size(const Function* func) const {
-    int size = 0;
-    for (const auto& bb : func->bbs) {
-        size += calculate_basic_block_size(bb.get());
-    }
-    return size;
+    bb->add_inst(std::make_unique<JumpValue>(blocks[callee->bbs[0]->name]));
+    new_blocks.push_back(std::move(cont));
+    caller->bbs.insert(caller->bbs.begin() + block_index + 1,
+                       std::make_move_iterator(new_blocks.begin()),
+                       std::make_move_iterator(new_blocks.end()));
 }
-
-int InlineOptimizer::calculate_basic_block_size(const BasicBlock* bb) const {
-    return static_cast<int>(bb->insts.size());
-} 
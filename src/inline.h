@@ -2,67 +2,63 @@
 #define INLINE_H
 
 #include "IR.h"
+#include "cfg.h"
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 
 // 函数内联优化器
+// 把被调函数的整个 CFG 复制到调用点：调用所在的块在调用处拆开，
+// 前半部分跳到复制出的函数体，所有 ret 改为写入调用结果后跳到后半部分。
+// 是否内联由代价模型决定：被调函数越小、调用点所在循环越深、常量实参越多，越值得内联。
 class InlineOptimizer {
 private:
     // 存储函数定义，用于内联时查找函数体
     std::unordered_map<std::string, Function*> function_map;
-    
-    // 记录已内联的函数，避免递归内联
-    std::unordered_set<std::string> inlined_functions;
-    
+
+    // 调用点的内联深度，从被调函数复制出的调用比原调用深一层，防止无限内联相互递归的函数
+    std::unordered_map<const CallValue*, int> call_depth;
+
     // 内联深度限制，防止过度内联
     int inline_depth_limit;
-    int current_depth;
-    
-    // 内联大小限制，防止内联过大的函数
+
+    // 内联大小限制：不在循环中的调用点，被调函数扣除收益后的大小不能超过它，每深一层循环放宽一倍
     int inline_size_limit;
-    
+
+    // 每个函数因内联而增加的最大指令数
+    int growth_limit;
+
 public:
-    InlineOptimizer(int depth_limit = 3, int size_limit = 50);
-    
+    InlineOptimizer(int depth_limit = 3, int size_limit = 50, int growth_limit = 1000);
+
     // 对程序进行函数内联优化
     void optimize(Program* program);
-    
+
+private:
     // 对单个函数进行内联优化
     void optimize_function(Function* func);
-    
-    // 对基本块进行内联优化
-    void optimize_basic_block(BasicBlock* bb);
-    
-    // 检查函数是否可以内联
-    bool can_inline(const Function* func) const;
-    
-    // 检查函数调用是否可以内联
-    bool can_inline_call(const CallValue* call, const Function* callee) const;
-    
-    // 执行函数内联，返回内联后的指令列表
-    std::vector<std::unique_ptr<IRValue>> inline_function_call(CallValue* call, Function* callee);
-    
-    // 计算函数的大小（指令数量）
+
+    // 函数是否直接调用自身
+    bool is_recursive(const Function* func) const;
+
+    // 计算函数的大小（不含 alloc 的指令数量）
     int calculate_function_size(const Function* func) const;
-    
-    // 计算基本块的大小（指令数量）
-    int calculate_basic_block_size(const BasicBlock* bb) const;
-    
-    // 替换参数引用
-    std::string replace_param_reference(const std::string& param_name, 
-                                       const std::vector<std::string>& args);
-    
-    // 生成新的临时变量名
+
+    // 内联的收益：省去的调用开销，以及常量实参使被调函数中可以折叠的指令
+    int inline_bonus(const CallValue* call, const Function* callee) const;
+
+    // 代价模型：调用点是否值得内联
+    bool should_inline(const CallValue* call, const Function* callee, int loop_depth) const;
+
+    // 内联 caller 第 block_index 个块中第 inst_index 条指令（对 callee 的调用）
+    void inline_call(Function* caller, size_t block_index, size_t inst_index, const Function* callee);
+
+    // 生成新的临时变量名 / 基本块名
     std::string generate_temp_name();
-    
-    // 克隆指令（用于内联）
-    std::unique_ptr<IRValue> clone_instruction(const IRValue* inst, 
-                                              std::unordered_map<std::string, std::string>& var_mapping,
-                                              const std::vector<std::string>& arg_names);
-    
-private:
+    std::string generate_block_name(const Function* func);
+
     static int temp_counter;
 };
 
-#endif // INLINE_H 
\ No newline at end of file
+#endif // INLINE_H
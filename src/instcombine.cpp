@@ -0,0 +1,395 @@
+#include "instcombine.h"
+#include <cstdint>
+
+using Context = InstCombineOptimizer::Context;
+
+namespace {
+
+// 规则：命中时改写指令并返回 true
+struct Rule {
+    const char* name;
+    bool (*apply)(Context& ctx, BinaryValue* bin);
+};
+
+const Rule rules[] = {
+    // 规范化：常量放到右边，比较运算同时交换方向
+    {"const-to-rhs", [](Context& ctx, BinaryValue* bin) {
+        int c;
+        if (!ctx.get_const(bin->lhs.get(), c) || ctx.get_const(bin->rhs.get(), c)) {
+            return false;
+        }
+        if (is_commutative(bin->op) || is_compare(bin->op)) {
+            bin->op = swap_compare(bin->op);
+            std::swap(bin->lhs, bin->rhs);
+            return true;
+        }
+        return false;
+    }},
+
+    // x - c => x + (-c)，便于合并常量链
+    {"sub-const", [](Context& ctx, BinaryValue* bin) {
+        int c;
+        if (bin->op != BinaryOp::SUB || !ctx.get_const(bin->rhs.get(), c) || c == 0) {
+            return false;
+        }
+        ctx.rewrite(bin, BinaryOp::ADD, bin->lhs.get(),
+                    static_cast<int>(0u - static_cast<uint32_t>(c)));
+        return true;
+    }},
+
+    // 单位元：x + 0, x - 0, x | 0, x ^ 0, x << 0, x * 1, x / 1, x & -1 => x
+    {"identity", [](Context& ctx, BinaryValue* bin) {
+        int c;
+        if (!ctx.get_const(bin->rhs.get(), c)) {
+            return false;
+        }
+        bool hit = false;
+        switch (bin->op) {
+            case BinaryOp::ADD:
+            case BinaryOp::SUB:
+            case BinaryOp::OR:
+            case BinaryOp::XOR:
+            case BinaryOp::SHL:
+            case BinaryOp::SHR:
+            case BinaryOp::SAR:
+                hit = c == 0;
+                break;
+            case BinaryOp::MUL:
+            case BinaryOp::DIV:
+                hit = c == 1;
+                break;
+            case BinaryOp::AND:
+                hit = c == -1;
+                break;
+            default:
+                break;
+        }
+        if (hit) {
+            ctx.replace(bin, bin->lhs.get());
+        }
+        return hit;
+    }},
+
+    // 零元：x * 0, x & 0, x % 1, x % -1 => 0；x | -1 => -1
+    {"absorb", [](Context& ctx, BinaryValue* bin) {
+        int c;
+        if (!ctx.get_const(bin->rhs.get(), c)) {
+            return false;
+        }
+        if (((bin->op == BinaryOp::MUL || bin->op == BinaryOp::AND) && c == 0) ||
+            (bin->op == BinaryOp::MOD && (c == 1 || c == -1)) ||
+            (bin->op == BinaryOp::OR && c == -1)) {
+            IntergerValue result(bin->op == BinaryOp::OR ? -1 : 0);
+            ctx.replace(bin, &result);
+            return true;
+        }
+        return false;
+    }},
+
+    // x * -1, x / -1 => 0 - x
+    {"negate", [](Context& ctx, BinaryValue* bin) {
+        if ((bin->op != BinaryOp::MUL && bin->op != BinaryOp::DIV) || !ctx.is_const(bin->rhs.get(), -1)) {
+            return false;
+        }
+        IntergerValue zero(0);
+        ctx.rewrite(bin, BinaryOp::SUB, &zero, bin->lhs.get());
+        return true;
+    }},
+
+    // 两个操作数相同：x - x, x ^ x => 0；x & x, x | x => x；x == x => 1 ...
+    {"same-operands", [](Context& ctx, BinaryValue* bin) {
+        if (!ctx.same(bin->lhs.get(), bin->rhs.get())) {
+            return false;
+        }
+        int result;
+        switch (bin->op) {
+            case BinaryOp::AND:
+            case BinaryOp::OR:
+                ctx.replace(bin, bin->lhs.get());
+                return true;
+            case BinaryOp::SUB:
+            case BinaryOp::XOR:
+            case BinaryOp::NE:
+            case BinaryOp::LT:
+            case BinaryOp::GT:
+                result = 0;
+                break;
+            case BinaryOp::EQ:
+            case BinaryOp::LE:
+            case BinaryOp::GE:
+                result = 1;
+                break;
+            default:
+                return false;
+        }
+        IntergerValue value(result);
+        ctx.replace(bin, &value);
+        return true;
+    }},
+
+    // 0 - (a - b) => b - a，特别地 0 - (0 - x) => x - 0
+    {"neg-sub", [](Context& ctx, BinaryValue* bin) {
+        if (bin->op != BinaryOp::SUB || !ctx.is_const(bin->lhs.get(), 0)) {
+            return false;
+        }
+        BinaryValue* inner = ctx.def_of(bin->rhs.get(), BinaryOp::SUB);
+        if (!inner || !ctx.is_stable(inner->lhs.get()) || !ctx.is_stable(inner->rhs.get())) {
+            return false;
+        }
+        ctx.rewrite(bin, BinaryOp::SUB, inner->rhs.get(), inner->lhs.get());
+        return true;
+    }},
+
+    // x + (0 - y) => x - y；(0 - y) + x => x - y；x - (0 - y) => x + y
+    {"add-neg", [](Context& ctx, BinaryValue* bin) {
+        if (bin->op != BinaryOp::ADD && bin->op != BinaryOp::SUB) {
+            return false;
+        }
+        auto neg_of = [&](const IRValue* v) -> const IRValue* {
+            BinaryValue* inner = ctx.def_of(v, BinaryOp::SUB);
+            if (inner && ctx.is_const(inner->lhs.get(), 0) && ctx.is_stable(inner->rhs.get())) {
+                return inner->rhs.get();
+            }
+            return nullptr;
+        };
+        BinaryOp flipped = bin->op == BinaryOp::ADD ? BinaryOp::SUB : BinaryOp::ADD;
+        if (const IRValue* y = neg_of(bin->rhs.get())) {
+            ctx.rewrite(bin, flipped, bin->lhs.get(), y);
+            return true;
+        }
+        if (bin->op == BinaryOp::ADD) {
+            if (const IRValue* y = neg_of(bin->lhs.get())) {
+                ctx.rewrite(bin, BinaryOp::SUB, bin->rhs.get(), y);
+                return true;
+            }
+        }
+        return false;
+    }},
+
+    // 常量链重结合：(x op c1) op c2 => x op (c1 op c2)，op 为 + * & | ^
+    {"reassociate-const", [](Context& ctx, BinaryValue* bin) {
+        int c2, c1;
+        if (!ctx.get_const(bin->rhs.get(), c2)) {
+            return false;
+        }
+        switch (bin->op) {
+            case BinaryOp::ADD:
+            case BinaryOp::MUL:
+            case BinaryOp::AND:
+            case BinaryOp::OR:
+            case BinaryOp::XOR:
+                break;
+            default:
+                return false;
+        }
+        BinaryValue* inner = ctx.def_of(bin->lhs.get(), bin->op);
+        if (!inner || !ctx.get_const(inner->rhs.get(), c1) || !ctx.is_stable(inner->lhs.get())) {
+            return false;
+        }
+        int c;
+        fold_binary_const(bin->op, c1, c2, c);
+        ctx.rewrite(bin, bin->op, inner->lhs.get(), c);
+        return true;
+    }},
+
+    // (x + c1) == c2 => x == c2 - c1，!= 同理
+    {"compare-offset", [](Context& ctx, BinaryValue* bin) {
+        int c2, c1;
+        if ((bin->op != BinaryOp::EQ && bin->op != BinaryOp::NE) || !ctx.get_const(bin->rhs.get(), c2)) {
+            return false;
+        }
+        BinaryValue* inner = ctx.def_of(bin->lhs.get(), BinaryOp::ADD);
+        if (!inner || !ctx.get_const(inner->rhs.get(), c1) || !ctx.is_stable(inner->lhs.get())) {
+            return false;
+        }
+        uint32_t c = static_cast<uint32_t>(c2) - static_cast<uint32_t>(c1);
+        ctx.rewrite(bin, bin->op, inner->lhs.get(), static_cast<int>(c));
+        return true;
+    }},
+
+    // 比较结果只有 0/1：cmp != 0 => cmp；(a < b) == 0 => a >= b
+    {"compare-of-compare", [](Context& ctx, BinaryValue* bin) {
+        if ((bin->op != BinaryOp::EQ && bin->op != BinaryOp::NE) || !ctx.is_const(bin->rhs.get(), 0)) {
+            return false;
+        }
+        BinaryValue* inner = nullptr;
+        for (BinaryOp op : {BinaryOp::EQ, BinaryOp::NE, BinaryOp::LT, BinaryOp::LE,
+                            BinaryOp::GT, BinaryOp::GE}) {
+            if ((inner = ctx.def_of(bin->lhs.get(), op))) {
+                break;
+            }
+        }
+        if (!inner) {
+            return false;
+        }
+        if (bin->op == BinaryOp::NE) {
+            ctx.replace(bin, bin->lhs.get());
+            return true;
+        }
+        if (!ctx.is_stable(inner->lhs.get()) || !ctx.is_stable(inner->rhs.get())) {
+            return false;
+        }
+        ctx.rewrite(bin, negate_compare(inner->op), inner->lhs.get(), inner->rhs.get());
+        return true;
+    }},
+};
+
+} // namespace
+
+bool Context::get_const(const IRValue* v, int& c) const {
+    if (v->v_tag != IRValueTag::INTEGER) {
+        return false;
+    }
+    c = static_cast<const IntergerValue*>(v)->value;
+    return true;
+}
+
+bool Context::is_const(const IRValue* v, int c) const {
+    int value;
+    return get_const(v, value) && value == c;
+}
+
+bool Context::is_stable(const IRValue* v) const {
+    if (v->v_tag != IRValueTag::VAR_REF) {
+        return true;
+    }
+    if (variables.count(v->name)) {
+        return fixed_variables.count(v->name) > 0;
+    }
+    auto it = def_count.find(v->name);
+    return it != def_count.end() && it->second == 1;
+}
+
+BinaryValue* Context::def_of(const IRValue* v, BinaryOp op) const {
+    if (v->v_tag != IRValueTag::VAR_REF) {
+        return nullptr;
+    }
+    auto it = binary_defs.find(v->name);
+    if (it == binary_defs.end() || it->second->op != op) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+bool Context::same(const IRValue* a, const IRValue* b) const {
+    // 同一条指令中的两个操作数，同名即同值
+    if (a->v_tag == IRValueTag::INTEGER && b->v_tag == IRValueTag::INTEGER) {
+        return static_cast<const IntergerValue*>(a)->value == static_cast<const IntergerValue*>(b)->value;
+    }
+    return a->v_tag == IRValueTag::VAR_REF && b->v_tag == IRValueTag::VAR_REF && a->name == b->name;
+}
+
+void Context::replace(BinaryValue* bin, const IRValue* value) {
+    auto copy = clone_inst(value);
+    binary_defs.erase(bin->name);
+
+    if (def_count[bin->name] != 1 || !is_stable(copy.get())) {
+        // 变量的值可能在之后被改变，保留为一次读取
+        int type = copy->v_tag == IRValueTag::INTEGER ? 1 : 0;
+        replaced.push_back({bin, std::make_unique<LoadValue>(bin->name, std::move(copy), type)});
+        return;
+    }
+
+    for (auto& bb : func->bbs) {
+        for (auto& inst : bb->insts) {
+            for (auto* op : get_operands(inst.get())) {
+                if ((*op)->v_tag == IRValueTag::VAR_REF && (*op)->name == bin->name) {
+                    *op = clone_inst(copy.get());
+                }
+            }
+            if (inst->v_tag == IRValueTag::LOAD) {
+                auto* load = static_cast<LoadValue*>(inst.get());
+                if (load->src->v_tag == IRValueTag::INTEGER) {
+                    load->type = 1;
+                }
+            }
+        }
+    }
+    replaced.push_back({bin, nullptr});
+}
+
+void Context::rewrite(BinaryValue* bin, BinaryOp op, const IRValue* lhs, const IRValue* rhs) {
+    // 操作数可能属于 bin 自身，先复制
+    auto new_lhs = clone_inst(lhs);
+    auto new_rhs = clone_inst(rhs);
+    bin->op = op;
+    bin->lhs = std::move(new_lhs);
+    bin->rhs = std::move(new_rhs);
+}
+
+void Context::rewrite(BinaryValue* bin, BinaryOp op, const IRValue* lhs, int rhs) {
+    IntergerValue value(rhs);
+    rewrite(bin, op, lhs, &value);
+}
+
+void InstCombineOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+void InstCombineOptimizer::optimize_function(Function* func) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        Context ctx;
+        ctx.func = func;
+        for (const auto& bb : func->bbs) {
+            for (const auto& inst : bb->insts) {
+                if (inst->v_tag == IRValueTag::ALLOC) {
+                    ctx.variables.insert(inst->name);
+                }
+                std::string def = get_def(inst.get());
+                if (!def.empty()) {
+                    ctx.def_count[def]++;
+                }
+            }
+        }
+        for (const auto& inst : func->bbs[0]->insts) {
+            // alloc 与一次 store
+            if (inst->v_tag == IRValueTag::STORE && ctx.def_count[get_def(inst.get())] == 2) {
+                ctx.fixed_variables.insert(get_def(inst.get()));
+            }
+        }
+        for (const auto& bb : func->bbs) {
+            for (const auto& inst : bb->insts) {
+                if (inst->v_tag == IRValueTag::BINARY && !ctx.variables.count(inst->name) &&
+                    ctx.def_count[inst->name] == 1) {
+                    ctx.binary_defs[inst->name] = static_cast<BinaryValue*>(inst.get());
+                }
+            }
+        }
+
+        for (const auto& bb : func->bbs) {
+            for (const auto& inst : bb->insts) {
+                if (inst->v_tag != IRValueTag::BINARY) {
+                    continue;
+                }
+                auto* bin = static_cast<BinaryValue*>(inst.get());
+                for (const Rule& rule : rules) {
+                    if (rule.apply(ctx, bin)) {
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        for (auto& [old_inst, new_inst] : ctx.replaced) {
+            for (auto& bb : func->bbs) {
+                for (auto it = bb->insts.begin(); it != bb->insts.end(); ++it) {
+                    if (it->get() != old_inst) {
+                        continue;
+                    }
+                    if (new_inst) {
+                        *it = std::move(new_inst);
+                    } else {
+                        bb->insts.erase(it);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
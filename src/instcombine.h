@@ -0,0 +1,60 @@
+#ifndef INSTCOMBINE_H
+#define INSTCOMBINE_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 基于规则表的代数化简（类似 LLVM 的 InstCombine）
+// 规则在 instcombine.cpp 的规则表中声明，每条规则匹配一条 BinaryValue 及其操作数的定义，
+// 命中后原地改写该指令，或用一个更简单的值替换它的所有使用。
+// 对函数反复应用所有规则，直到不再变化。
+class InstCombineOptimizer {
+public:
+    InstCombineOptimizer() = default;
+
+    void optimize(Program* program);
+
+    // 规则使用的上下文
+    struct Context {
+        Function* func;
+        // 只定义一次的临时变量 -> 其 BinaryValue 定义
+        std::unordered_map<std::string, BinaryValue*> binary_defs;
+        // 每个名字的定义次数（store 也算）
+        std::unordered_map<std::string, int> def_count;
+        // 函数中的变量（alloc 定义），其值会被 store 改变
+        std::unordered_set<std::string> variables;
+        // 只在 entry 块中 store 一次的变量（如参数的副本），此后值不再改变
+        std::unordered_set<std::string> fixed_variables;
+        // 待替换的指令，nullptr 表示删除
+        std::vector<std::pair<IRValue*, std::unique_ptr<IRValue>>> replaced;
+
+        // 操作数是否为常量
+        bool get_const(const IRValue* v, int& c) const;
+        bool is_const(const IRValue* v, int c) const;
+
+        // 操作数在任何位置读取都得到同一个值（常量、只定义一次的临时变量或 fixed_variables）
+        bool is_stable(const IRValue* v) const;
+
+        // 操作数由只定义一次的 BinaryValue 计算得到，返回该定义，否则返回 nullptr
+        BinaryValue* def_of(const IRValue* v, BinaryOp op) const;
+
+        // 两个操作数是否一定相等
+        bool same(const IRValue* a, const IRValue* b) const;
+
+        // 用 value 替换 bin 的所有使用，bin 本身变为死代码
+        void replace(BinaryValue* bin, const IRValue* value);
+
+        // 原地改写 bin
+        void rewrite(BinaryValue* bin, BinaryOp op, const IRValue* lhs, const IRValue* rhs);
+        void rewrite(BinaryValue* bin, BinaryOp op, const IRValue* lhs, int rhs);
+    };
+
+private:
+    void optimize_function(Function* func);
+};
+
+#endif // INSTCOMBINE_H
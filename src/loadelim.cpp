@@ -0,0 +1,187 @@
+#include "loadelim.h"
+#include <algorithm>
+
+namespace {
+
+std::unique_ptr<IRValue> make_value(const std::string& name) {
+    if (name.compare(0, 5, "$imm_") == 0) {
+        return std::make_unique<IntergerValue>(std::stoi(name.substr(5)));
+    }
+    return std::make_unique<VarRefValue>(name);
+}
+
+// 从常量 load 的改为 li
+void set_li(IRValue* inst) {
+    if (inst->v_tag == IRValueTag::LOAD) {
+        auto* load = static_cast<LoadValue*>(inst);
+        if (load->src->v_tag == IRValueTag::INTEGER) {
+            load->type = 1;
+        }
+    }
+}
+
+} // namespace
+
+void LoadEliminationOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+std::string LoadEliminationOptimizer::value_of(const IRValue* v, const Available& avail) const {
+    if (v->v_tag == IRValueTag::INTEGER || temps.count(v->name)) {
+        return v->name;
+    }
+    auto it = avail.find(v->name);
+    return it == avail.end() ? "" : it->second;
+}
+
+void LoadEliminationOptimizer::transfer(const IRValue* inst, Available& avail) const {
+    if (inst->v_tag == IRValueTag::STORE) {
+        auto* store = static_cast<const StoreValue*>(inst);
+        const std::string& var = store->dest->name;
+        if (!variables.count(var)) {
+            return;
+        }
+        std::string value = value_of(store->value.get(), avail);
+        if (value.empty()) {
+            avail.erase(var);
+        } else {
+            avail[var] = value;
+        }
+        return;
+    }
+    if (inst->v_tag == IRValueTag::ALLOC || inst->name.empty()) {
+        return;
+    }
+
+    // 重新定义的临时变量不再等于之前 store 的值
+    for (auto it = avail.begin(); it != avail.end();) {
+        it = it->second == inst->name ? avail.erase(it) : std::next(it);
+    }
+    if (inst->v_tag == IRValueTag::LOAD && temps.count(inst->name)) {
+        auto* load = static_cast<const LoadValue*>(inst);
+        const std::string& var = load->src->name;
+        if (variables.count(var) && !avail.count(var)) {
+            avail[var] = inst->name;
+        }
+    }
+}
+
+void LoadEliminationOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+    remove_unreachable_blocks(func);
+
+    auto& bbs = func->bbs;
+    int n = bbs.size();
+    CFG cfg = build_cfg(func);
+
+    variables.clear();
+    temps.clear();
+    std::unordered_map<std::string, int> def_count;
+    for (const auto& bb : bbs) {
+        for (const auto& inst : bb->insts) {
+            if (inst->v_tag == IRValueTag::ALLOC) {
+                variables.insert(inst->name);
+            } else if (inst->v_tag != IRValueTag::STORE && !inst->name.empty()) {
+                def_count[inst->name]++;
+            }
+        }
+    }
+    for (const auto& [name, count] : def_count) {
+        if (count == 1 && !variables.count(name)) {
+            temps.insert(name);
+        }
+    }
+
+    // 可用值分析，交汇为所有已访问前驱的交集
+    std::vector<Available> in(n), out(n);
+    std::vector<bool> visited(n, false);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int b = 0; b < n; b++) {
+            Available env;
+            bool first = true;
+            for (int p : cfg.preds[b]) {
+                if (!visited[p]) {
+                    continue;
+                }
+                if (first) {
+                    env = out[p];
+                    first = false;
+                    continue;
+                }
+                for (auto it = env.begin(); it != env.end();) {
+                    auto other = out[p].find(it->first);
+                    bool keep = other != out[p].end() && other->second == it->second;
+                    it = keep ? std::next(it) : env.erase(it);
+                }
+            }
+            if (b == 0) {
+                env.clear();
+            }
+            in[b] = env;
+            for (const auto& inst : bbs[b]->insts) {
+                transfer(inst.get(), env);
+            }
+            if (!visited[b] || env != out[b]) {
+                visited[b] = true;
+                out[b] = std::move(env);
+                changed = true;
+            }
+        }
+    }
+
+    // 可用值已知的 load 删除，其结果改为可用值；直接读取的变量改为可用的常量
+    std::unordered_map<std::string, std::string> replaced;
+    for (int b = 0; b < n; b++) {
+        Available env = in[b];
+        auto& insts = bbs[b]->insts;
+        for (auto& inst : insts) {
+            if (inst->v_tag == IRValueTag::LOAD && temps.count(inst->name)) {
+                auto* load = static_cast<LoadValue*>(inst.get());
+                auto it = env.find(load->src->name);
+                if (load->type == 0 && variables.count(load->src->name) && it != env.end()) {
+                    replaced[inst->name] = it->second;
+                    inst.reset();
+                    continue;
+                }
+            }
+            for (auto* op : get_operands(inst.get())) {
+                if ((*op)->v_tag != IRValueTag::VAR_REF || !variables.count((*op)->name)) {
+                    continue;
+                }
+                // 变量本身就分配在寄存器中，只有常量值才值得替换直接读取
+                auto it = env.find((*op)->name);
+                if (it != env.end() && it->second.compare(0, 5, "$imm_") == 0) {
+                    *op = make_value(it->second);
+                }
+            }
+            set_li(inst.get());
+            transfer(inst.get(), env);
+        }
+        insts.erase(std::remove(insts.begin(), insts.end(), nullptr), insts.end());
+    }
+    if (replaced.empty()) {
+        return;
+    }
+
+    // 被删除的 load 的结果可能又被转发给了另一个 load
+    auto resolve = [&](std::string name) {
+        for (auto it = replaced.find(name); it != replaced.end(); it = replaced.find(name)) {
+            name = it->second;
+        }
+        return name;
+    };
+    for (auto& bb : bbs) {
+        for (auto& inst : bb->insts) {
+            for (auto* op : get_operands(inst.get())) {
+                if ((*op)->v_tag == IRValueTag::VAR_REF && replaced.count((*op)->name)) {
+                    *op = make_value(resolve((*op)->name));
+                }
+            }
+            set_li(inst.get());
+        }
+    }
+}
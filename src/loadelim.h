@@ -0,0 +1,40 @@
+#ifndef LOADELIM_H
+#define LOADELIM_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+// 冗余 load 消除与 store 到 load 的转发，不需要 SSA。
+// 对每个局部变量（alloc 定义）做可用值分析：store 常量或临时变量之后、load 到临时变量之后，
+// 变量的值在此后未被改写的路径上等于该常量或临时变量；重新执行该临时变量的定义也使其失效。
+// 在所有前驱上可用值都相同时才可用。
+// 可用值已知的 load 被删除，其结果的使用改为可用值；直接读取变量的操作数在可用值为常量时改为该常量。
+class LoadEliminationOptimizer {
+public:
+    LoadEliminationOptimizer() = default;
+
+    void optimize(Program* program);
+
+private:
+    // 变量 -> 可用值的名字（$imm_N 形式的常量或临时变量）
+    using Available = std::map<std::string, std::string>;
+
+    void optimize_function(Function* func);
+
+    // 操作数在 avail 下的值，无法确定时返回空串
+    std::string value_of(const IRValue* v, const Available& avail) const;
+
+    // 执行一条指令后的可用值
+    void transfer(const IRValue* inst, Available& avail) const;
+
+    // 函数中的局部变量
+    std::unordered_set<std::string> variables;
+    // 只定义一次的临时变量，可以作为可用值
+    std::unordered_set<std::string> temps;
+};
+
+#endif // LOADELIM_H
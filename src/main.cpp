@@ -5,21 +5,156 @@
 #include <string>
 
 #include "ast.h"
+#include "callgraph.h"
 #include "consprop.h"
+#include "consteval.h"
+#include "copyprop.h"
+#include "dce.h"
+#include "ifconvert.h"
 #include "visit.h"
 #include "inline.h"
+#include "instcombine.h"
+#include "loadelim.h"
+#include "memoize.h"
+#include "partial_inline.h"
+#include "peel.h"
+#include "pre.h"
+#include "reassoc.h"
+#include "scev.h"
+#include "simplifycfg.h"
+#include "sink.h"
+#include "specialize.h"
+#include "superblock.h"
+#include "tailrec.h"
+#include "unswitch.h"
+#include "valuerange.h"
 
 using namespace std;
 
 extern FILE *yyin;
 extern int yyparse(unique_ptr<BaseAST> &ast);
 
+// 优化流水线，-opt-ir 与 -opt 共用
+static void optimize_program(Program *program, bool memo) {
+    // 部分内联：递归函数开头的提前返回留在原函数，其余部分外提，原函数交给内联
+    PartialInlineOptimizer partial_inliner;
+    partial_inliner.optimize(program);
+
+    // 执行函数内联优化
+    InlineOptimizer inliner;
+    inliner.optimize(program);
+
+    // 把 store 的值转发给之后的 load，删除重复的 load
+    LoadEliminationOptimizer loadelim;
+    loadelim.optimize(program);
+
+    // li 和复制的使用改为其源，删除复制
+    CopyPropagationOptimizer copyprop;
+    copyprop.optimize(program);
+
+    // 执行常量传播，控制流简化
+    ConstantPropagationOptimizer consprop;
+    consprop.optimize(program);
+
+    // 代数化简
+    InstCombineOptimizer instcombine;
+    instcombine.optimize(program);
+
+    // 区间与已知位：化简结果已知的比较和布尔运算，折叠被支配条件蕴含的分支
+    ValueRangeOptimizer valuerange;
+    valuerange.optimize(program);
+    consprop.optimize(program);
+
+    // 合并内联留下的跳转链，绕过空块，线程化结果已知的分支
+    CFGSimplifyOptimizer simplifycfg;
+    simplifycfg.optimize(program);
+
+    // 为常量实参的调用点生成特化版本
+    FunctionSpecializationOptimizer specialize;
+    specialize.optimize(program);
+
+    // 删除不可达的函数和无用的纯函数调用
+    CallGraphOptimizer callgraph;
+    callgraph.optimize(program);
+
+    // 实参全为常量的纯函数调用在编译期求值
+    ConstEvalOptimizer evaluator;
+    evaluator.optimize(program);
+    consprop.optimize(program);
+    instcombine.optimize(program);
+
+    // 记忆化纯递归函数（-memo 开启），会占用 .bss 中的表；
+    // 要在尾递归之前判断，尾递归会把 fib 这类函数的一处递归调用变成循环
+    if (memo) {
+        MemoizeOptimizer memoize;
+        memoize.optimize(program);
+    }
+
+    // 尾递归变为循环，产生的循环交给后面的循环优化
+    TailRecursionOptimizer tailrec;
+    tailrec.optimize(program);
+
+    // 循环外提：把不变条件提到循环外，让循环体变成直线代码
+    LoopUnswitchOptimizer unswitch;
+    unswitch.optimize(program);
+
+    // 循环剥离：剥出第一轮与之后不同的迭代，常量传播折叠副本中的分支后，循环头处的标志成为常量
+    LoopPeelOptimizer peel;
+    peel.optimize(program);
+    consprop.optimize(program);
+    simplifycfg.optimize(program);
+    consprop.optimize(program);
+
+    // 标量演化：用闭式替换归纳变量的循环，之后再做一次常量传播
+    ScalarEvolutionOptimizer scev;
+    scev.optimize(program);
+    loadelim.optimize(program);
+    copyprop.optimize(program);
+    consprop.optimize(program);
+    instcombine.optimize(program);
+    valuerange.optimize(program);
+    consprop.optimize(program);
+
+    // 重结合：合并常量，循环不变的部分先组合以便 PRE 外提，长链变为平衡树
+    ReassociationOptimizer reassoc;
+    reassoc.optimize(program);
+
+    // 部分冗余消除：在缺少表达式的边上插入计算，使之后的重复计算变为冗余
+    PartialRedundancyOptimizer pre;
+    pre.optimize(program);
+
+    // 只在某个分支中使用的值下沉到该分支
+    CodeSinkingOptimizer sink;
+    sink.optimize(program);
+
+    // 小的 if/if-else 赋值变成无分支的选择序列
+    IfConversionOptimizer ifconvert;
+    ifconvert.optimize(program);
+    valuerange.optimize(program);
+
+    // 超级块：沿静态预测的热路径复制汇合块，在整条路径上做局部值编号
+    SuperblockOptimizer superblock;
+    superblock.optimize(program);
+    loadelim.optimize(program);
+    copyprop.optimize(program);
+    instcombine.optimize(program);
+
+    callgraph.optimize(program);
+
+    // 删除死存储、死循环等无用代码
+    DeadCodeEliminationOptimizer dce;
+    dce.optimize(program);
+    simplifycfg.optimize(program);
+    copyprop.optimize(program);
+}
+
 /** Usage:
  * ./compiler <input_file>
  * ./compiler -a <input_file>     # AST mode
  * ./compiler -ir <input_file>    # IR mode
  * ./compiler -opt-ir <input_file> # IR with optimization
  * ./compiler -opt <input_file> # Assembly code with optimization
+ * ./compiler -opt -memo <input_file> # also memoize pure recursive functions
  * The input file should contain the source code to be parsed.
  */
 int main(int argc, char *argv[]) {
@@ -27,23 +162,31 @@ int main(int argc, char *argv[]) {
     int ir_mode = 0;
     int opt_ir_mode = 0;
     int opt_mode = 0;
+    int memo_mode = 0;
 
     char* input;
 
-    assert(argc == 2 || argc == 3);
-    if (argc == 3) {
+    assert(argc >= 2 && argc <= 4);
+    if (argc == 4) {
+        if (string(argv[2]) == "-memo") {
+            memo_mode = 1;
+        } else {
+            std::cout << "Unknown option: " << argv[2] << std::endl;
+        }
+    }
+    if (argc >= 3) {
         if (string(argv[1]) == "-a") {
             ast_mode = 1;
         } else if (string(argv[1]) == "-ir") {
             ir_mode = 1;
         } else if (string(argv[1]) == "-opt-ir") {
             opt_ir_mode = 1;
-        } else if (string(argv[1]) == "opt") {
+        } else if (string(argv[1]) == "-opt") {
             opt_mode = 1;
         } else {
             std::cout << "Unknown option: " << argv[1] << std::endl;
         }
-        input = argv[2];
+        input = argv[argc - 1];
     } else {
         input = argv[1];
     }
@@ -62,28 +205,14 @@ int main(int argc, char *argv[]) {
         cout << comp_unit->to_IR()->toString() << endl;
     } else if (opt_ir_mode) {
         auto program = comp_unit->to_IR();
-        
-        // 执行函数内联优化 - 允许内联更大的函数
-        //InlineOptimizer optimizer(1, 10); // 深度限制1，大小限制10
-        //optimizer.optimize(program.get());
-
-        // 执行常量传播，控制流简化
-        ConstantPropagationOptimizer optimizer2;
-        optimizer2.optimize(program.get());
-        
+        optimize_program(program.get(), memo_mode);
+
         cout << "// 优化后的IR代码:" << endl;
         cout << program->toString() << endl;
     } else if (opt_mode) {
         auto program = comp_unit->to_IR();
-        
-        // 执行函数内联优化 - 允许内联更大的函数
-        //InlineOptimizer optimizer(1, 10); // 深度限制1，大小限制10
-        //optimizer.optimize(program.get());
-
-        // 执行常量传播，控制流简化
-        ConstantPropagationOptimizer optimizer2;
-        optimizer2.optimize(program.get());
-        
+        optimize_program(program.get(), memo_mode);
+
         cout << "// 优化后的汇编代码:" << endl;
         cout << visit_program(std::move(program)) << endl;
     } else {
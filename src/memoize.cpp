@@ -0,0 +1,33 @@
+#include "memoize.h"
+
+MemoizeOptimizer::MemoizeOptimizer(int table_size) : table_size(table_size) {}
+
+int MemoizeOptimizer::count_self_calls(const Function* func) const {
+    int count = 0;
+    for (const auto& bb : func->bbs) {
+        for (const auto& inst : bb->insts) {
+            auto* call = dynamic_cast<const CallValue*>(inst.get());
+            if (call && call->callee == func->name) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+void MemoizeOptimizer::optimize(Program* program) {
+    auto effects = compute_effects(build_call_graph(program));
+    for (auto& func : program->funcs) {
+        if (func->name == "@main" || func->params.size() != 1 || !func->f_type->return_type->isInt32()) {
+            continue;
+        }
+        if (!effects[func->name].pure) {
+            continue;
+        }
+        // 只有一处递归调用时是线性递归，记忆化没有渐进收益
+        if (count_self_calls(func.get()) < 2) {
+            continue;
+        }
+        func->memo_table_size = table_size;
+    }
+}
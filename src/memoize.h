@@ -0,0 +1,26 @@
+#ifndef MEMOIZE_H
+#define MEMOIZE_H
+
+#include "IR.h"
+#include "callgraph.h"
+
+// 纯递归函数的自动记忆化（需要 -memo 开启）
+// 只有一个 int 参数、返回 int、至少有两处调用自身的纯函数（如朴素的 fib）会被标记，
+// 生成汇编时在函数入口查一张 .bss 中的直接映射表（见 visit.cpp 中的 visit_memo_wrapper）：
+// 参数在 [0, table_size) 内且已计算过时直接返回表中的结果，否则执行原函数体并填表。
+// 纯函数的结果只由实参决定，因此对所有输入都与原函数等价。
+class MemoizeOptimizer {
+public:
+    MemoizeOptimizer(int table_size = 1024);
+
+    void optimize(Program* program);
+
+private:
+    // 表的项数
+    int table_size;
+
+    // 函数中调用自身的次数
+    int count_self_calls(const Function* func) const;
+};
+
+#endif // MEMOIZE_H
@@ -0,0 +1,195 @@
+#include "partial_inline.h"
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+int PartialInlineOptimizer::temp_counter = 0;
+
+PartialInlineOptimizer::PartialInlineOptimizer(int guard_limit, int size_limit)
+    : guard_limit(guard_limit), size_limit(size_limit) {
+}
+
+std::string PartialInlineOptimizer::generate_function_name(const Function* func) {
+    std::ostringstream oss;
+    oss << func->name << "_cold_" << temp_counter++;
+    return oss.str();
+}
+
+bool PartialInlineOptimizer::find_guard(const Function* func, const CFG& cfg, Guard& guard) const {
+    const auto& entry = func->bbs[0]->insts;
+    auto* br = entry.empty() ? nullptr : dynamic_cast<const BranchValue*>(entry.back().get());
+    if (!br || cfg.succs[0].size() != 2 || cfg.succs[0][0] == cfg.succs[0][1]) {
+        return false;
+    }
+
+    // entry 块中只能有计算和参数副本的初始化，冷路径重新执行 entry 时结果不变
+    std::unordered_set<std::string> params;
+    for (const auto& param : func->params) {
+        params.insert(param->name);
+    }
+    int size = 0;
+    for (const auto& inst : entry) {
+        if (inst->v_tag == IRValueTag::CALL) {
+            return false;
+        }
+        if (auto* store = dynamic_cast<const StoreValue*>(inst.get())) {
+            if (!params.count(store->value->name)) {
+                return false;
+            }
+        }
+        if (inst->v_tag != IRValueTag::ALLOC) {
+            size++;
+        }
+    }
+
+    for (int i = 0; i < 2; i++) {
+        int fast = cfg.succs[0][i];
+        int cold = cfg.succs[0][1 - i];
+        const auto& insts = func->bbs[fast]->insts;
+        if (insts.empty() || insts.back()->v_tag != IRValueTag::RETURN || cfg.preds[fast].size() != 1) {
+            continue;
+        }
+        bool has_call = false;
+        for (const auto& inst : insts) {
+            has_call = has_call || inst->v_tag == IRValueTag::CALL;
+        }
+        if (has_call || size + static_cast<int>(insts.size()) > guard_limit) {
+            continue;
+        }
+        guard.fast = fast;
+        guard.cold = cold;
+        return true;
+    }
+    return false;
+}
+
+std::unique_ptr<Function> PartialInlineOptimizer::outline(const Function* func, const Guard& guard) {
+    std::string name = generate_function_name(func);
+
+    std::vector<std::unique_ptr<IRType>> param_types;
+    for (size_t i = 0; i < func->params.size(); i++) {
+        param_types.push_back(std::make_unique<Int32Type>());
+    }
+    std::unique_ptr<IRType> ret_type;
+    if (func->f_type->return_type->isUnit()) {
+        ret_type = std::make_unique<UnitType>();
+    } else {
+        ret_type = std::make_unique<Int32Type>();
+    }
+    auto cold = std::make_unique<Function>(name, std::make_unique<FunctionType>(std::move(param_types),
+                                                                                std::move(ret_type)));
+    cold->local_var_count = func->local_var_count;
+    for (size_t i = 0; i < func->params.size(); i++) {
+        cold->add_param(std::make_unique<FuncArgRefValue>(i, func->params[i]->name));
+    }
+
+    // 块名在汇编中是全局标号，加上新函数名作为前缀
+    std::unordered_map<std::string, std::string> blocks;
+    for (const auto& bb : func->bbs) {
+        blocks[bb->name] = bb == func->bbs[0] ? bb->name : "%" + name.substr(1) + "_" + bb->name.substr(1);
+    }
+
+    for (size_t b = 0; b < func->bbs.size(); b++) {
+        const auto& bb = func->bbs[b];
+        auto new_bb = std::make_unique<BasicBlock>(blocks[bb->name]);
+        for (const auto& inst : bb->insts) {
+            auto new_inst = clone_inst(inst.get());
+            if (b == 0 && new_inst->v_tag == IRValueTag::BRANCH) {
+                // 进入冷函数时守卫条件一定不成立
+                new_inst = std::make_unique<JumpValue>(blocks[func->bbs[guard.cold]->name]);
+            } else if (auto* br = dynamic_cast<BranchValue*>(new_inst.get())) {
+                br->true_block = blocks[br->true_block];
+                br->false_block = blocks[br->false_block];
+            } else if (auto* jump = dynamic_cast<JumpValue*>(new_inst.get())) {
+                jump->target_block = blocks[jump->target_block];
+            }
+            new_bb->add_inst(std::move(new_inst));
+        }
+        cold->add_basic_block(std::move(new_bb));
+    }
+    remove_unreachable_blocks(cold.get());
+    return cold;
+}
+
+void PartialInlineOptimizer::optimize(Program* program) {
+    for (size_t f = 0; f < program->funcs.size(); f++) {
+        Function* func = program->funcs[f].get();
+        if (func->name == "@main" || func->bbs.empty()) {
+            continue;
+        }
+        normalize_terminators(func);
+
+        // 能整体内联的函数不需要部分内联；
+        // 只有一处递归调用的线性递归每次只命中一次基本情况，而且交给 TailRecursionOptimizer 变成循环更好
+        int self_calls = 0;
+        int size = 0;
+        for (const auto& bb : func->bbs) {
+            for (const auto& inst : bb->insts) {
+                const auto* call = dynamic_cast<const CallValue*>(inst.get());
+                if (call && call->callee == func->name) {
+                    self_calls++;
+                }
+                if (inst->v_tag != IRValueTag::ALLOC) {
+                    size++;
+                }
+            }
+        }
+        if (self_calls == 1 || (self_calls == 0 && size <= size_limit)) {
+            continue;
+        }
+
+        CFG cfg = build_cfg(func);
+        Guard guard;
+        if (!find_guard(func, cfg, guard)) {
+            continue;
+        }
+        auto cold = outline(func, guard);
+
+        // 冷分支改为以参数副本的当前值调用冷函数
+        std::unordered_map<std::string, std::string> copies;
+        for (const auto& inst : func->bbs[0]->insts) {
+            if (auto* store = dynamic_cast<const StoreValue*>(inst.get())) {
+                copies[store->value->name] = store->dest->name;
+            }
+        }
+        std::vector<std::unique_ptr<IRValue>> args;
+        for (const auto& param : func->params) {
+            auto it = copies.find(param->name);
+            if (it != copies.end()) {
+                args.push_back(std::make_unique<VarRefValue>(it->second));
+            } else {
+                args.push_back(std::make_unique<IntergerValue>(0)); // 未使用的参数
+            }
+        }
+        std::unique_ptr<IRType> ret_type;
+        if (func->f_type->return_type->isUnit()) {
+            ret_type = std::make_unique<UnitType>();
+        } else {
+            ret_type = std::make_unique<Int32Type>();
+        }
+        std::string result = "%partial_" + std::to_string(temp_counter++);
+        auto call_bb = std::make_unique<BasicBlock>("%" + func->get_func_name() + "_partial_" +
+                                                    std::to_string(temp_counter++));
+        bool is_void = ret_type->isUnit();
+        call_bb->add_inst(std::make_unique<CallValue>(result, cold->name, args, std::move(ret_type)));
+        if (is_void) {
+            call_bb->add_inst(std::make_unique<ReturnValue>());
+        } else {
+            call_bb->add_inst(std::make_unique<ReturnValue>(std::make_unique<VarRefValue>(result)));
+        }
+
+        auto* br = static_cast<BranchValue*>(func->bbs[0]->insts.back().get());
+        const std::string& cold_name = func->bbs[guard.cold]->name;
+        if (br->true_block == cold_name) {
+            br->true_block = call_bb->name;
+        } else {
+            br->false_block = call_bb->name;
+        }
+        func->add_basic_block(std::move(call_bb));
+        remove_unreachable_blocks(func);
+
+        // 冷函数放在原函数之前，内联时先把原函数内联进冷函数，冷函数因此成为直接递归而不会被反向内联
+        program->funcs.insert(program->funcs.begin() + f, std::move(cold));
+        f++;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef PARTIAL_INLINE_H
+#define PARTIAL_INLINE_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <memory>
+#include <string>
+
+// 部分内联：把函数开头的提前返回分支（如递归的 if (n <= 1) return n;）留在原函数，
+// 其余的冷路径外提为一个新函数 f_cold_N，原函数的冷分支改为调用它。
+// 原函数因此变得很小且不再直接递归，随后的 InlineOptimizer 会把它内联到各调用点（包括 f_cold_N 中的递归调用），
+// 命中基本情况的调用不再需要 call。
+// 只处理整体无法内联（有多处递归调用，或超过内联大小限制）、而 entry 块加快速路径不超过 guard_limit 条指令的函数。
+class PartialInlineOptimizer {
+public:
+    PartialInlineOptimizer(int guard_limit = 8, int size_limit = 50);
+
+    void optimize(Program* program);
+
+private:
+    // entry 块末尾的分支：fast 块没有调用并以 ret 结束，cold 为另一个后继
+    struct Guard {
+        int fast = -1;
+        int cold = -1;
+    };
+
+    // entry 块加快速路径的最大指令数
+    int guard_limit;
+
+    // 与 InlineOptimizer 的大小限制一致，不超过它的非递归函数会被整体内联
+    int size_limit;
+
+    // 函数开头是否为可以部分内联的提前返回分支
+    bool find_guard(const Function* func, const CFG& cfg, Guard& guard) const;
+
+    // 复制 func，entry 直接跳到冷路径，返回外提出的新函数
+    std::unique_ptr<Function> outline(const Function* func, const Guard& guard);
+
+    std::string generate_function_name(const Function* func);
+
+    static int temp_counter;
+};
+
+#endif // PARTIAL_INLINE_H
@@ -0,0 +1,424 @@
+#include "peel.h"
+#include <algorithm>
+#include <sstream>
+
+int LoopPeelOptimizer::temp_counter = 0;
+
+LoopPeelOptimizer::LoopPeelOptimizer(int max_peel, int loop_size_limit, int growth_limit)
+    : max_peel(max_peel), loop_size_limit(loop_size_limit), growth_limit(growth_limit) {}
+
+std::string LoopPeelOptimizer::generate_temp_name() {
+    std::ostringstream oss;
+    oss << "%peel_" << temp_counter++;
+    return oss.str();
+}
+
+std::string LoopPeelOptimizer::generate_block_name(const Function* func) {
+    std::ostringstream oss;
+    oss << "%" << func->get_func_name() << "_peel_" << temp_counter++;
+    return oss.str();
+}
+
+void LoopPeelOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+bool LoopPeelOptimizer::run_block(const Function* func, const CFG& cfg, int b, State& state, int& next) const {
+    auto value_of = [&](const IRValue* v, int& out) {
+        if (v->v_tag == IRValueTag::INTEGER) {
+            out = static_cast<const IntergerValue*>(v)->value;
+            return true;
+        }
+        auto it = state.find(v->name);
+        if (it == state.end()) {
+            return false;
+        }
+        out = it->second;
+        return true;
+    };
+
+    for (const auto& inst : func->bbs[b]->insts) {
+        int l, r, result;
+        switch (inst->v_tag) {
+            case IRValueTag::LOAD:
+                if (value_of(static_cast<const LoadValue*>(inst.get())->src.get(), result)) {
+                    state[inst->name] = result;
+                } else {
+                    state.erase(inst->name);
+                }
+                break;
+            case IRValueTag::BINARY: {
+                auto* bin = static_cast<const BinaryValue*>(inst.get());
+                if (value_of(bin->lhs.get(), l) && value_of(bin->rhs.get(), r) && fold_binary_const(bin->op, l, r, result)) {
+                    state[inst->name] = result;
+                } else {
+                    state.erase(inst->name);
+                }
+                break;
+            }
+            case IRValueTag::STORE: {
+                auto* store = static_cast<const StoreValue*>(inst.get());
+                if (value_of(store->value.get(), result)) {
+                    state[store->dest->name] = result;
+                } else {
+                    state.erase(store->dest->name);
+                }
+                break;
+            }
+            case IRValueTag::CALL:
+                state.erase(inst->name);
+                break;
+            case IRValueTag::BRANCH: {
+                auto* br = static_cast<const BranchValue*>(inst.get());
+                if (!value_of(br->cond.get(), result)) {
+                    return false;
+                }
+                next = cfg.index.at(result ? br->true_block : br->false_block);
+                return true;
+            }
+            case IRValueTag::JUMP:
+                next = cfg.index.at(static_cast<const JumpValue*>(inst.get())->target_block);
+                return true;
+            case IRValueTag::RETURN:
+                next = -1;
+                return true;
+            default:
+                break;
+        }
+    }
+    next = -1;
+    return true;
+}
+
+LoopPeelOptimizer::State LoopPeelOptimizer::entry_state(const Function* func, const std::vector<int>& idom,
+                                                        const std::vector<Loop>& loops, const Loop& loop) const {
+    // 循环外对每个变量的 store
+    std::unordered_map<std::string, std::vector<std::pair<int, const StoreValue*>>> stores;
+    for (int b = 0; b < (int)func->bbs.size(); b++) {
+        if (loop.blocks.count(b)) {
+            continue;
+        }
+        for (const auto& inst : func->bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::STORE) {
+                stores[get_def(inst.get())].push_back({b, static_cast<const StoreValue*>(inst.get())});
+            }
+        }
+    }
+
+    State state;
+    for (const auto& [var, list] : stores) {
+        if (list.size() != 1 || list[0].second->value->v_tag != IRValueTag::INTEGER ||
+            !dominates(idom, list[0].first, loop.header)) {
+            continue;
+        }
+        bool same_outer = true;
+        for (const auto& outer : loops) {
+            if (&outer != &loop && outer.blocks.count(loop.header) && !outer.blocks.count(list[0].first)) {
+                same_outer = false;
+            }
+        }
+        if (same_outer) {
+            state[var] = static_cast<const IntergerValue*>(list[0].second->value.get())->value;
+        }
+    }
+    return state;
+}
+
+int LoopPeelOptimizer::peel_count(const Function* func, const CFG& cfg, const std::vector<int>& idom,
+                                  const std::vector<Loop>& loops, const Loop& loop) {
+    const auto& bbs = func->bbs;
+    if (loop.header == 0) {
+        return 0;
+    }
+    int size = 0;
+    for (int b : loop.blocks) {
+        size += bbs[b]->insts.size();
+    }
+    if (size > loop_size_limit) {
+        return 0;
+    }
+
+    // 在循环中只被 store 同一个常量的变量 -> 该常量
+    State steady;
+    std::unordered_set<std::string> varying;
+    for (int b : loop.blocks) {
+        for (const auto& inst : bbs[b]->insts) {
+            if (inst->v_tag != IRValueTag::STORE) {
+                continue;
+            }
+            auto* store = static_cast<const StoreValue*>(inst.get());
+            const std::string& var = store->dest->name;
+            if (store->value->v_tag != IRValueTag::INTEGER) {
+                varying.insert(var);
+                continue;
+            }
+            int c = static_cast<const IntergerValue*>(store->value.get())->value;
+            auto it = steady.find(var);
+            if (it != steady.end() && it->second != c) {
+                varying.insert(var);
+            }
+            steady[var] = c;
+        }
+    }
+    for (const auto& var : varying) {
+        steady.erase(var);
+    }
+
+    // 进入循环时与稳定值不同的变量，剥离后它们在循环头处才成为常量
+    State state = entry_state(func, idom, loops, loop);
+    std::vector<std::string> flipped;
+    for (const auto& [var, c] : steady) {
+        auto it = state.find(var);
+        if (it != state.end() && it->second != c) {
+            flipped.push_back(var);
+        }
+    }
+    if (flipped.empty()) {
+        return 0;
+    }
+
+    for (int k = 1; k <= max_peel; k++) {
+        // 解释执行一轮迭代，中途离开循环或遇到循环内未知的分支都不剥离
+        int b = loop.header;
+        for (int steps = 0;; steps++) {
+            int next;
+            if (!run_block(func, cfg, b, state, next)) {
+                // 未知的退出条件按留在循环中处理，剥出的副本中仍保留这个判断
+                auto* br = static_cast<const BranchValue*>(bbs[b]->insts.back().get());
+                int t = cfg.index.at(br->true_block), f = cfg.index.at(br->false_block);
+                if (loop.blocks.count(t) == loop.blocks.count(f)) {
+                    return 0;
+                }
+                next = loop.blocks.count(t) ? t : f;
+            }
+            if (steps > (int)loop.blocks.size() || next < 0 || !loop.blocks.count(next)) {
+                return 0;
+            }
+            if (next == loop.header) {
+                break;
+            }
+            b = next;
+        }
+        bool settled = std::all_of(flipped.begin(), flipped.end(), [&](const std::string& var) {
+            auto it = state.find(var);
+            return it != state.end() && it->second == steady[var];
+        });
+        if (!settled) {
+            continue;
+        }
+
+        // 稳定状态下有分支的条件成为常量
+        State known;
+        for (const auto& var : flipped) {
+            known[var] = steady[var];
+        }
+        for (int blk : loop.blocks) {
+            if (bbs[blk]->insts.back()->v_tag != IRValueTag::BRANCH) {
+                continue;
+            }
+            State s = known;
+            int next;
+            if (run_block(func, cfg, blk, s, next)) {
+                return k;
+            }
+        }
+        return 0;
+    }
+    return 0;
+}
+
+void LoopPeelOptimizer::peel(Function* func, const CFG& cfg, const Loop& loop) {
+    auto& bbs = func->bbs;
+    int n = bbs.size();
+    std::string header = bbs[loop.header]->name;
+
+    // 循环中定义的临时变量在副本中全部改名，使每个定义仍只有一个名字
+    std::unordered_map<std::string, std::string> rename;
+    std::unordered_map<std::string, std::string> block_map;
+    for (int b : loop.blocks) {
+        block_map[bbs[b]->name] = generate_block_name(func);
+        for (const auto& inst : bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::STORE || inst->v_tag == IRValueTag::ALLOC) {
+                continue;
+            }
+            std::string def = get_def(inst.get());
+            if (!def.empty() && !rename.count(def)) {
+                rename[def] = generate_temp_name();
+            }
+        }
+    }
+
+    // 被改名的临时变量在各块入口处的活跃性，决定副本的入口和出口需要哪些复制
+    std::unordered_set<std::string> defined_outside;
+    std::vector<std::unordered_set<std::string>> use(n), def(n), live_in(n);
+    for (int b = 0; b < n; b++) {
+        for (const auto& inst : bbs[b]->insts) {
+            for (auto* op : get_operands(inst.get())) {
+                if (rename.count((*op)->name) && !def[b].count((*op)->name)) {
+                    use[b].insert((*op)->name);
+                }
+            }
+            std::string d = inst->v_tag == IRValueTag::STORE ? "" : get_def(inst.get());
+            if (rename.count(d)) {
+                def[b].insert(d);
+                if (!loop.blocks.count(b)) {
+                    defined_outside.insert(d);
+                }
+            }
+        }
+    }
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int b = n - 1; b >= 0; b--) {
+            std::unordered_set<std::string> live = use[b];
+            for (int s : cfg.succs[b]) {
+                for (const auto& name : live_in[s]) {
+                    if (!def[b].count(name)) {
+                        live.insert(name);
+                    }
+                }
+            }
+            if (live.size() != live_in[b].size()) {
+                live_in[b] = std::move(live);
+                changed = true;
+            }
+        }
+    }
+
+    // 离开副本（进入循环外或回到原循环头）的边上把改名后的值复制回原来的名字
+    std::vector<std::unique_ptr<BasicBlock>> edges;
+    auto map_block = [&](std::string& target) {
+        if (target != header && block_map.count(target)) {
+            target = block_map[target];
+            return;
+        }
+        std::vector<std::string> names;
+        for (const auto& name : live_in[cfg.index.at(target)]) {
+            names.push_back(name);
+        }
+        if (names.empty()) {
+            return;
+        }
+        std::sort(names.begin(), names.end());
+        auto edge = std::make_unique<BasicBlock>(generate_block_name(func));
+        for (const auto& name : names) {
+            edge->add_inst(std::make_unique<LoadValue>(name, std::make_unique<VarRefValue>(rename[name])));
+        }
+        edge->add_inst(std::make_unique<JumpValue>(target));
+        target = edge->name;
+        edges.push_back(std::move(edge));
+    };
+
+    std::vector<std::unique_ptr<BasicBlock>> clones;
+    for (int b : loop.blocks) {
+        auto copy = std::make_unique<BasicBlock>(block_map[bbs[b]->name]);
+        peeled.insert(copy->name);
+        // 进入循环时沿用循环外的定义
+        if (b == loop.header) {
+            std::vector<std::string> names;
+            for (const auto& name : live_in[b]) {
+                if (defined_outside.count(name)) {
+                    names.push_back(name);
+                }
+            }
+            std::sort(names.begin(), names.end());
+            for (const auto& name : names) {
+                copy->add_inst(std::make_unique<LoadValue>(rename[name], std::make_unique<VarRefValue>(name)));
+            }
+        }
+        for (const auto& inst : bbs[b]->insts) {
+            auto c = clone_inst(inst.get());
+            for (auto* op : get_operands(c.get())) {
+                auto it = rename.find((*op)->name);
+                if ((*op)->v_tag == IRValueTag::VAR_REF && it != rename.end()) {
+                    *op = std::make_unique<VarRefValue>(it->second);
+                }
+            }
+            if (c->v_tag != IRValueTag::STORE && rename.count(c->name)) {
+                c->name = rename[c->name];
+            }
+            if (c->v_tag == IRValueTag::BRANCH) {
+                auto* br = static_cast<BranchValue*>(c.get());
+                bool same = br->true_block == br->false_block;
+                map_block(br->true_block);
+                if (same) {
+                    br->false_block = br->true_block;
+                } else {
+                    map_block(br->false_block);
+                }
+            } else if (c->v_tag == IRValueTag::JUMP) {
+                map_block(static_cast<JumpValue*>(c.get())->target_block);
+            }
+            copy->add_inst(std::move(c));
+        }
+        clones.push_back(std::move(copy));
+    }
+    for (auto& edge : edges) {
+        clones.push_back(std::move(edge));
+    }
+
+    // 从循环外进入循环头的边改为进入副本
+    for (int p : cfg.preds[loop.header]) {
+        if (loop.blocks.count(p)) {
+            continue;
+        }
+        IRValue* term = bbs[p]->insts.back().get();
+        if (term->v_tag == IRValueTag::JUMP) {
+            static_cast<JumpValue*>(term)->target_block = block_map[header];
+        } else if (term->v_tag == IRValueTag::BRANCH) {
+            auto* br = static_cast<BranchValue*>(term);
+            if (br->true_block == header) br->true_block = block_map[header];
+            if (br->false_block == header) br->false_block = block_map[header];
+        }
+    }
+    bbs.insert(bbs.begin() + loop.header, std::make_move_iterator(clones.begin()),
+               std::make_move_iterator(clones.end()));
+}
+
+void LoopPeelOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+    remove_unreachable_blocks(func);
+
+    peeled.clear();
+    int budget = growth_limit;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        CFG cfg = build_cfg(func);
+        auto idom = compute_idom(cfg);
+        auto loops = find_loops(cfg, idom);
+        for (const auto& loop : loops) {
+            std::string header = func->bbs[loop.header]->name;
+            if (peeled.count(header)) {
+                continue;
+            }
+            peeled.insert(header);
+            int k = peel_count(func, cfg, idom, loops, loop);
+            int size = 0;
+            for (int b : loop.blocks) {
+                size += func->bbs[b]->insts.size();
+            }
+            if (k == 0 || k * size > budget) {
+                continue;
+            }
+            budget -= k * size;
+
+            // 每剥离一轮都重新分析，下一轮的副本插在上一轮的副本与循环头之间
+            peel(func, cfg, loop);
+            for (int i = 1; i < k; i++) {
+                CFG again = build_cfg(func);
+                auto again_loops = find_loops(again, compute_idom(again));
+                for (const auto& l : again_loops) {
+                    if (func->bbs[l.header]->name == header) {
+                        peel(func, again, l);
+                        break;
+                    }
+                }
+            }
+            changed = true;
+            break;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef PEEL_H
+#define PEEL_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+// 循环剥离（loop peeling）
+// 循环前初始化、在循环中被翻转的标志（first = 1; ... if (first) { ...; first = 0; }）
+// 使循环体中的分支一直依赖于循环中变化的变量，常量传播在循环头处只能得到非常量。
+// 对每个循环，取进入循环时已知为常量的变量，按常量解释执行前几轮迭代：
+// 若若干轮之后，所有在循环中只被 store 同一个常量 c 的变量都已经等于 c，
+// 且此时循环中有分支的条件成为常量，就把这几轮迭代剥到循环之前。
+// 剥出的副本中分支由常量传播折叠，剩下的循环在循环头处这些变量都为 c，稳定状态的分支也被折叠。
+// 复制会使代码膨胀，因此限制剥离的轮数、单个循环的大小和每个函数的总增长量。
+class LoopPeelOptimizer {
+public:
+    LoopPeelOptimizer(int max_peel = 2, int loop_size_limit = 48, int growth_limit = 192);
+
+    void optimize(Program* program);
+
+private:
+    // 变量或临时变量 -> 已知的常量值
+    using State = std::unordered_map<std::string, int>;
+
+    // 最多剥离的轮数
+    int max_peel;
+
+    // 可剥离的循环的最大指令数
+    int loop_size_limit;
+
+    // 每个函数因剥离而增加的最大指令数
+    int growth_limit;
+
+    void optimize_function(Function* func);
+
+    // 循环值得剥离的轮数，不值得时返回 0
+    int peel_count(const Function* func, const CFG& cfg, const std::vector<int>& idom,
+                   const std::vector<Loop>& loops, const Loop& loop);
+
+    // 进入循环时已知为常量的变量：循环外只有一次 store 常量，该 store 支配循环头，
+    // 且与循环头处于相同的外层循环中（每次进入循环之前都会重新执行）
+    State entry_state(const Function* func, const std::vector<int>& idom, const std::vector<Loop>& loops,
+                      const Loop& loop) const;
+
+    // 按常量解释执行一个块，state 随之更新；分支条件未知时返回 false，
+    // 否则 next 为后继的下标（ret 时为 -1）
+    bool run_block(const Function* func, const CFG& cfg, int b, State& state, int& next) const;
+
+    // 剥离一轮迭代：复制循环的所有块，从循环外进入循环头的边改为进入副本，副本的回边进入原循环头；
+    // 副本中定义的临时变量都改名，离开副本的边上再复制回原来的名字
+    void peel(Function* func, const CFG& cfg, const Loop& loop);
+
+    // 生成新的临时变量名 / 基本块名
+    std::string generate_temp_name();
+    std::string generate_block_name(const Function* func);
+
+    // 已经判断过或剥离产生的循环头，不再处理
+    std::unordered_set<std::string> peeled;
+
+    static int temp_counter;
+};
+
+#endif // PEEL_H
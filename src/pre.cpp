@@ -0,0 +1,378 @@
+#include "pre.h"
+#include <algorithm>
+#include <sstream>
+
+int PartialRedundancyOptimizer::temp_counter = 0;
+
+PartialRedundancyOptimizer::PartialRedundancyOptimizer(int max_rounds) : max_rounds(max_rounds) {}
+
+std::string PartialRedundancyOptimizer::generate_temp_name() {
+    std::ostringstream oss;
+    oss << "%pre_" << temp_counter++;
+    return oss.str();
+}
+
+std::string PartialRedundancyOptimizer::generate_block_name(const Function* func) {
+    std::ostringstream oss;
+    oss << "%" << func->get_func_name() << "_pre_" << temp_counter++;
+    return oss.str();
+}
+
+void PartialRedundancyOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        for (int round = 0; round < max_rounds; round++) {
+            if (!optimize_function(func.get())) {
+                break;
+            }
+        }
+    }
+}
+
+void PartialRedundancyOptimizer::collect_expressions(const Function* func) {
+    expressions.clear();
+    expression_index.clear();
+    occurrence.clear();
+    variables.clear();
+    for (const auto& bb : func->bbs) {
+        for (const auto& inst : bb->insts) {
+            if (inst->v_tag == IRValueTag::ALLOC) {
+                variables.insert(inst->name);
+            }
+        }
+    }
+
+    for (const auto& bb : func->bbs) {
+        // 块内每个变量被 store 的次数，load 得到的值只在次数不变时等于变量的当前值
+        std::unordered_map<std::string, int> version;
+        std::unordered_map<std::string, std::pair<Leaf, int>> loaded;
+        auto get_leaf = [&](const IRValue* v, Leaf& leaf) {
+            if (v->v_tag == IRValueTag::INTEGER) {
+                leaf.is_const = true;
+                leaf.value = static_cast<const IntergerValue*>(v)->value;
+                return true;
+            }
+            if (variables.count(v->name)) {
+                leaf.var = v->name;
+                return true;
+            }
+            auto it = loaded.find(v->name);
+            if (it == loaded.end()) {
+                return false;
+            }
+            leaf = it->second.first;
+            return leaf.is_const || version[leaf.var] == it->second.second;
+        };
+
+        for (const auto& inst : bb->insts) {
+            if (auto* store = dynamic_cast<const StoreValue*>(inst.get())) {
+                // 刚写入变量的临时变量与该变量的当前值相同
+                const std::string& var = store->dest->name;
+                version[var]++;
+                if (variables.count(var) && store->value->v_tag == IRValueTag::VAR_REF &&
+                    !variables.count(store->value->name)) {
+                    Leaf leaf;
+                    leaf.var = var;
+                    loaded[store->value->name] = {leaf, version[var]};
+                }
+            } else if (auto* load = dynamic_cast<const LoadValue*>(inst.get())) {
+                Leaf leaf;
+                if (get_leaf(load->src.get(), leaf)) {
+                    loaded[load->name] = {leaf, leaf.is_const ? 0 : version[leaf.var]};
+                }
+            } else if (auto* bin = dynamic_cast<const BinaryValue*>(inst.get())) {
+                Expression expr{bin->op, {}, {}, {}};
+                if (!get_leaf(bin->lhs.get(), expr.lhs) || !get_leaf(bin->rhs.get(), expr.rhs)) {
+                    continue;
+                }
+                if (expr.lhs.is_const && expr.rhs.is_const) {
+                    continue; // 留给常量传播
+                }
+                // 交换律运算的操作数按名字排序，常量放在右边
+                if (is_commutative(expr.op) &&
+                    (expr.lhs.is_const || (!expr.rhs.is_const && expr.rhs.key() < expr.lhs.key()))) {
+                    std::swap(expr.lhs, expr.rhs);
+                }
+                for (const Leaf* leaf : {&expr.lhs, &expr.rhs}) {
+                    if (!leaf->is_const) {
+                        expr.vars.insert(leaf->var);
+                    }
+                }
+                std::string key = std::to_string(static_cast<int>(expr.op)) + " " + expr.lhs.key() + " " +
+                                  expr.rhs.key();
+                auto it = expression_index.find(key);
+                if (it == expression_index.end()) {
+                    it = expression_index.emplace(key, expressions.size()).first;
+                    expressions.push_back(expr);
+                }
+                occurrence[inst.get()] = it->second;
+            }
+        }
+    }
+}
+
+bool PartialRedundancyOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+    remove_unreachable_blocks(func);
+    collect_expressions(func);
+    int n = func->bbs.size();
+    int m = expressions.size();
+    if (m == 0) {
+        return false;
+    }
+    CFG cfg = build_cfg(func);
+
+    // 局部性质：antloc 块中在任何改写之前计算，comp 块中在最后一次改写之后计算，transp 块中不改写
+    std::vector<std::vector<bool>> antloc(n, std::vector<bool>(m, false));
+    std::vector<std::vector<bool>> comp(n, std::vector<bool>(m, false));
+    std::vector<std::vector<bool>> transp(n, std::vector<bool>(m, true));
+    std::unordered_map<std::string, std::vector<int>> users;   // 变量 -> 使用它的表达式
+    for (int e = 0; e < m; e++) {
+        for (const auto& var : expressions[e].vars) {
+            users[var].push_back(e);
+        }
+    }
+    for (int b = 0; b < n; b++) {
+        for (const auto& inst : func->bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::STORE) {
+                for (int e : users[get_def(inst.get())]) {
+                    transp[b][e] = false;
+                    comp[b][e] = false;
+                }
+            }
+            auto it = occurrence.find(inst.get());
+            if (it != occurrence.end()) {
+                comp[b][it->second] = true;
+                if (transp[b][it->second]) {
+                    antloc[b][it->second] = true;
+                }
+            }
+        }
+    }
+
+    std::vector<std::pair<int, int>> edges;
+    std::vector<std::vector<int>> in_edges(n);
+    for (int b = 0; b < n; b++) {
+        for (int s : cfg.succs[b]) {
+            if (std::find(edges.begin(), edges.end(), std::make_pair(b, s)) == edges.end()) {
+                in_edges[s].push_back(edges.size());
+                edges.push_back({b, s});
+            }
+        }
+    }
+
+    // insert[e] 中为需要插入表达式 e 的边，replace[b][e] 表示块 b 中 e 的第一次计算可以读取 %pre
+    std::vector<std::vector<int>> insert(m);
+    std::vector<std::vector<bool>> replace(n, std::vector<bool>(m, false));
+    std::vector<bool> needed(m, false);
+    for (int e = 0; e < m; e++) {
+        // 可预期（anticipable）：从块入口出发的每条路径都会在改写前计算 e
+        std::vector<bool> antin(n, true), antout(n, true);
+        // 可用（available）：到达块出口的每条路径都已计算 e 且之后未被改写
+        std::vector<bool> avin(n, true), avout(n, true);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int b = n - 1; b >= 0; b--) {
+                bool out = !cfg.succs[b].empty();
+                for (int s : cfg.succs[b]) {
+                    out = out && antin[s];
+                }
+                bool in = antloc[b][e] || (transp[b][e] && out);
+                if (out != antout[b] || in != antin[b]) {
+                    antout[b] = out;
+                    antin[b] = in;
+                    changed = true;
+                }
+            }
+        }
+        changed = true;
+        while (changed) {
+            changed = false;
+            for (int b = 0; b < n; b++) {
+                bool in = b != 0;
+                for (int p : cfg.preds[b]) {
+                    in = in && avout[p];
+                }
+                bool out = comp[b][e] || (transp[b][e] && in);
+                if (in != avin[b] || out != avout[b]) {
+                    avin[b] = in;
+                    avout[b] = out;
+                    changed = true;
+                }
+            }
+        }
+
+        // 最早的插入位置，然后尽量推迟
+        auto earliest = [&](int i, int j) {
+            return antin[j] && !avout[i] && (!transp[i][e] || !antout[i]);
+        };
+        std::vector<bool> later(edges.size(), true);
+        std::vector<bool> laterin(n, true);
+        changed = true;
+        while (changed) {
+            changed = false;
+            for (int b = 0; b < n; b++) {
+                // entry 有一条来自虚拟起点的边，其上的 earliest 即 antin
+                bool in = b != 0 || antin[0];
+                for (int k : in_edges[b]) {
+                    in = in && later[k];
+                }
+                if (in != laterin[b]) {
+                    laterin[b] = in;
+                    changed = true;
+                }
+            }
+            for (size_t k = 0; k < edges.size(); k++) {
+                auto [i, j] = edges[k];
+                bool value = earliest(i, j) || (laterin[i] && !antloc[i][e]);
+                if (value != later[k]) {
+                    later[k] = value;
+                    changed = true;
+                }
+            }
+        }
+
+        for (size_t k = 0; k < edges.size(); k++) {
+            if (later[k] && !laterin[edges[k].second]) {
+                insert[e].push_back(k);
+            }
+        }
+        for (int b = 0; b < n; b++) {
+            if (antloc[b][e] && !laterin[b]) {
+                replace[b][e] = true;
+                needed[e] = true;
+            }
+        }
+    }
+
+    // 块内的重复计算也需要变量
+    for (int b = 0; b < n; b++) {
+        std::vector<bool> computed(m, false);
+        for (const auto& inst : func->bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::STORE) {
+                for (int e : users[get_def(inst.get())]) {
+                    computed[e] = false;
+                }
+            }
+            auto it = occurrence.find(inst.get());
+            if (it != occurrence.end()) {
+                needed[it->second] = needed[it->second] || computed[it->second];
+                computed[it->second] = true;
+            }
+        }
+    }
+    if (std::find(needed.begin(), needed.end(), true) == needed.end()) {
+        return false;
+    }
+
+    // 每个需要的表达式一个变量
+    std::vector<std::string> pre_var(m);
+    auto& entry_insts = func->bbs[0]->insts;
+    for (int e = 0; e < m; e++) {
+        if (needed[e]) {
+            pre_var[e] = generate_temp_name();
+            entry_insts.insert(entry_insts.begin(), std::make_unique<AllocValue>(pre_var[e]));
+        }
+    }
+
+    // 改写各块：能读变量的计算改为 load，其余计算把结果写入变量
+    for (int b = 0; b < n; b++) {
+        auto& insts = func->bbs[b]->insts;
+        std::vector<bool> holds = replace[b];
+        for (size_t i = 0; i < insts.size(); i++) {
+            IRValue* inst = insts[i].get();
+            if (inst->v_tag == IRValueTag::STORE) {
+                auto it = users.find(get_def(inst));
+                if (it != users.end()) {
+                    for (int e : it->second) {
+                        holds[e] = false;
+                    }
+                }
+                continue;
+            }
+            auto it = occurrence.find(inst);
+            if (it == occurrence.end() || !needed[it->second]) {
+                continue;
+            }
+            int e = it->second;
+            if (holds[e]) {
+                insts[i] = std::make_unique<LoadValue>(inst->name, std::make_unique<VarRefValue>(pre_var[e]));
+            } else {
+                insts.insert(insts.begin() + i + 1,
+                             std::make_unique<StoreValue>(std::make_unique<VarRefValue>(inst->name),
+                                                          std::make_unique<VarRefValue>(pre_var[e])));
+                holds[e] = true;
+                i++;
+            }
+        }
+    }
+
+    // 在边上插入计算：源块只有一个后继时放在其末尾，目标块只有一个前驱时放在其开头，
+    // 否则是关键边，拆分这条边
+    std::map<int, std::vector<int>> edge_exprs;
+    for (int e = 0; e < m; e++) {
+        if (!needed[e]) {
+            continue;
+        }
+        for (int k : insert[e]) {
+            edge_exprs[k].push_back(e);
+        }
+    }
+    auto make_leaf = [](const Leaf& leaf) -> std::unique_ptr<IRValue> {
+        if (leaf.is_const) {
+            return std::make_unique<IntergerValue>(leaf.value);
+        }
+        return std::make_unique<VarRefValue>(leaf.var);
+    };
+    std::vector<std::unique_ptr<BasicBlock>> new_blocks;
+    std::vector<std::string> new_block_targets;
+    for (const auto& [k, exprs] : edge_exprs) {
+        auto [i, j] = edges[k];
+        std::vector<std::unique_ptr<IRValue>> code;
+        for (int e : exprs) {
+            const Expression& expr = expressions[e];
+            std::string temp = generate_temp_name();
+            code.push_back(std::make_unique<BinaryValue>(temp, expr.op, make_leaf(expr.lhs), make_leaf(expr.rhs)));
+            code.push_back(std::make_unique<StoreValue>(std::make_unique<VarRefValue>(temp),
+                                                        std::make_unique<VarRefValue>(pre_var[e])));
+        }
+
+        auto& src = func->bbs[i]->insts;
+        if (cfg.succs[i].size() == 1) {
+            src.insert(src.end() - 1, std::make_move_iterator(code.begin()), std::make_move_iterator(code.end()));
+            continue;
+        }
+        auto& dst = func->bbs[j]->insts;
+        if (cfg.preds[j].size() == 1) {
+            dst.insert(dst.begin(), std::make_move_iterator(code.begin()), std::make_move_iterator(code.end()));
+            continue;
+        }
+        const std::string& target = func->bbs[j]->name;
+        auto block = std::make_unique<BasicBlock>(generate_block_name(func));
+        for (auto& inst : code) {
+            block->add_inst(std::move(inst));
+        }
+        block->add_inst(std::make_unique<JumpValue>(target));
+        auto* br = static_cast<BranchValue*>(src.back().get());
+        if (br->true_block == target) {
+            br->true_block = block->name;
+        }
+        if (br->false_block == target) {
+            br->false_block = block->name;
+        }
+        new_blocks.push_back(std::move(block));
+        new_block_targets.push_back(target);
+    }
+
+    // 拆分出的块放在目标块之前
+    for (size_t k = 0; k < new_blocks.size(); k++) {
+        auto pos = std::find_if(func->bbs.begin(), func->bbs.end(), [&](const std::unique_ptr<BasicBlock>& bb) {
+            return bb->name == new_block_targets[k];
+        });
+        if (pos == func->bbs.begin()) {
+            pos++;
+        }
+        func->bbs.insert(pos, std::move(new_blocks[k]));
+    }
+    return true;
+}
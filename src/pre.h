@@ -0,0 +1,64 @@
+#ifndef PRE_H
+#define PRE_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 部分冗余消除（lazy code motion，Knoop-Rüthing-Steffen）
+// 表达式为两个操作数都是常量或变量的二元运算（操作数可以是同一块中、此后未被 store 改写的 load，
+// 或刚 store 到变量中的临时变量）。
+// 在基于边的数据流分析下，把表达式插入到缺少它的边上，使之后的计算变为完全冗余：
+// 冗余的计算改为读取新变量 %pre_N，保留的计算和插入的计算把结果写入该变量。
+// 插入点尽量靠后（lazy），不会让任何路径上的计算次数增加；
+// 同一块中未被改写的重复计算也读取该变量（局部 CSE），因此也覆盖了完全冗余的情况。
+class PartialRedundancyOptimizer {
+public:
+    PartialRedundancyOptimizer(int max_rounds = 4);
+
+    void optimize(Program* program);
+
+private:
+    // 表达式的操作数：常量或变量
+    struct Leaf {
+        bool is_const = false;
+        int value = 0;
+        std::string var;
+
+        std::string key() const { return is_const ? "$" + std::to_string(value) : var; }
+    };
+
+    struct Expression {
+        BinaryOp op;
+        Leaf lhs, rhs;
+        std::set<std::string> vars;   // store 这些变量会使表达式失效
+    };
+
+    // 内层有嵌套的表达式在外层被替换成变量后才成为候选，因此重复若干轮
+    int max_rounds;
+
+    // 当前函数的表达式，以及每个出现位置（BinaryValue）对应的表达式下标
+    std::vector<Expression> expressions;
+    std::map<std::string, int> expression_index;
+    std::unordered_map<const IRValue*, int> occurrence;
+
+    // 当前函数中的变量（alloc 定义）
+    std::set<std::string> variables;
+
+    bool optimize_function(Function* func);
+
+    // 收集函数中的表达式及其出现位置
+    void collect_expressions(const Function* func);
+
+    // 生成新的临时变量名 / 基本块名
+    std::string generate_temp_name();
+    std::string generate_block_name(const Function* func);
+
+    static int temp_counter;
+};
+
+#endif // PRE_H
@@ -0,0 +1,247 @@
+#include "reassoc.h"
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <unordered_set>
+
+int ReassociationOptimizer::temp_counter = 0;
+
+std::string ReassociationOptimizer::generate_temp_name() {
+    std::ostringstream oss;
+    oss << "%reassoc_" << temp_counter++;
+    return oss.str();
+}
+
+void ReassociationOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+namespace {
+
+bool is_associative(BinaryOp op) {
+    return op == BinaryOp::ADD || op == BinaryOp::MUL || op == BinaryOp::AND || op == BinaryOp::OR ||
+           op == BinaryOp::XOR;
+}
+
+int identity(BinaryOp op) {
+    switch (op) {
+        case BinaryOp::MUL: return 1;
+        case BinaryOp::AND: return -1;
+        default: return 0;
+    }
+}
+
+// 树中的一个值：叶子或新生成的中间结果
+struct Operand {
+    std::unique_ptr<IRValue> value;
+    int rank = 0;
+    int height = 0;
+};
+
+} // namespace
+
+void ReassociationOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+    remove_unreachable_blocks(func);
+
+    auto& bbs = func->bbs;
+    int n = bbs.size();
+    CFG cfg = build_cfg(func);
+    auto idom = compute_idom(cfg);
+    auto loops = find_loops(cfg, idom);
+    std::vector<int> depth(n, 0);
+    for (const auto& loop : loops) {
+        for (int b : loop.blocks) {
+            depth[b] = std::max(depth[b], loop.depth);
+        }
+    }
+
+    // 叶子的秩：临时变量为定义所在块的循环深度，变量为 store 它的最深的块的循环深度
+    std::unordered_set<std::string> variables;
+    std::unordered_map<std::string, int> def_count, use_count, rank;
+    for (int b = 0; b < n; b++) {
+        for (const auto& inst : bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::ALLOC) {
+                variables.insert(inst->name);
+                continue;
+            }
+            std::string def = get_def(inst.get());
+            if (!def.empty()) {
+                def_count[def]++;
+                rank[def] = std::max(rank[def], depth[b]);
+            }
+            for (auto* op : get_operands(inst.get())) {
+                use_count[(*op)->name]++;
+            }
+        }
+    }
+
+    for (int b = 0; b < n; b++) {
+        auto& insts = bbs[b]->insts;
+        int m = insts.size();
+
+        // 树的内部结点：只定义一次、只被本块中后面的同种运算使用一次的结果
+        std::unordered_map<std::string, int> position;
+        std::unordered_map<std::string, int> parent;
+        for (int i = 0; i < m; i++) {
+            position[insts[i]->name] = i;
+            if (insts[i]->v_tag != IRValueTag::BINARY) {
+                continue;
+            }
+            auto* bin = static_cast<BinaryValue*>(insts[i].get());
+            if (!is_associative(bin->op)) {
+                continue;
+            }
+            for (const IRValue* op : {bin->lhs.get(), bin->rhs.get()}) {
+                auto it = position.find(op->name);
+                if (it == position.end() || insts[it->second]->v_tag != IRValueTag::BINARY ||
+                    static_cast<BinaryValue*>(insts[it->second].get())->op != bin->op ||
+                    variables.count(op->name) || def_count[op->name] != 1 || use_count[op->name] != 1) {
+                    continue;
+                }
+                parent[op->name] = i;
+            }
+        }
+
+        // 位置 i 的指令是否改为了 rewritten[i] 中的指令序列，被合并的内部结点标记为删除
+        std::unordered_map<int, std::vector<std::unique_ptr<IRValue>>> rewritten;
+        std::vector<bool> removed(m, false);
+        for (int root = m - 1; root >= 0; root--) {
+            auto* bin = dynamic_cast<BinaryValue*>(insts[root].get());
+            if (!bin || !is_associative(bin->op) || parent.count(bin->name) || removed[root]) {
+                continue;
+            }
+            BinaryOp op = bin->op;
+
+            // 展开成叶子，记录原树高
+            std::vector<const IRValue*> leaves;
+            std::vector<int> leaf_position;
+            std::vector<int> interior;
+            std::function<int(int)> flatten = [&](int i) {
+                auto* node = static_cast<BinaryValue*>(insts[i].get());
+                int height = 0;
+                for (const IRValue* child : {node->lhs.get(), node->rhs.get()}) {
+                    auto it = parent.find(child->name);
+                    if (it != parent.end() && it->second == i) {
+                        int c = position[child->name];
+                        interior.push_back(c);
+                        height = std::max(height, flatten(c));
+                    } else {
+                        leaves.push_back(child);
+                        leaf_position.push_back(i);
+                    }
+                }
+                return height + 1;
+            };
+            int old_height = flatten(root);
+            if (interior.empty()) {
+                continue;
+            }
+
+            // 叶子移到树根处读取，中间不能被重新定义（变量的 store 或多次定义的临时变量）
+            bool movable = true;
+            for (size_t k = 0; k < leaves.size() && movable; k++) {
+                if (leaves[k]->v_tag == IRValueTag::INTEGER) {
+                    continue;
+                }
+                for (int i = leaf_position[k] + 1; i < root; i++) {
+                    if (get_def(insts[i].get()) == leaves[k]->name) {
+                        movable = false;
+                        break;
+                    }
+                }
+            }
+            if (!movable) {
+                continue;
+            }
+
+            // 合并常量，其余叶子按秩分组
+            int constant = identity(op);
+            int const_count = 0;
+            std::vector<Operand> operands;
+            for (const IRValue* leaf : leaves) {
+                if (leaf->v_tag == IRValueTag::INTEGER) {
+                    fold_binary_const(op, constant, static_cast<const IntergerValue*>(leaf)->value, constant);
+                    const_count++;
+                    continue;
+                }
+                auto it = rank.find(leaf->name);
+                operands.push_back({clone_inst(leaf), it == rank.end() ? 0 : it->second, 0});
+            }
+            std::stable_sort(operands.begin(), operands.end(), [](const Operand& a, const Operand& b) {
+                return a.rank < b.rank;
+            });
+            bool mixed_ranks = !operands.empty() && operands.front().rank != operands.back().rank;
+
+            std::vector<std::unique_ptr<IRValue>> seq;
+            auto combine = [&](Operand a, Operand b) {
+                std::string name = generate_temp_name();
+                seq.push_back(std::make_unique<BinaryValue>(name, op, std::move(a.value), std::move(b.value)));
+                return Operand{std::make_unique<VarRefValue>(name), std::max(a.rank, b.rank),
+                               std::max(a.height, b.height) + 1};
+            };
+
+            // 每个秩内组合成平衡树，再按秩从小到大依次组合
+            Operand acc;
+            for (size_t start = 0; start < operands.size();) {
+                size_t end = start;
+                while (end < operands.size() && operands[end].rank == operands[start].rank) {
+                    end++;
+                }
+                std::vector<Operand> level;
+                for (size_t k = start; k < end; k++) {
+                    level.push_back(std::move(operands[k]));
+                }
+                while (level.size() > 1) {
+                    std::vector<Operand> next;
+                    for (size_t k = 0; k + 1 < level.size(); k += 2) {
+                        next.push_back(combine(std::move(level[k]), std::move(level[k + 1])));
+                    }
+                    if (level.size() % 2) {
+                        next.push_back(std::move(level.back()));
+                    }
+                    level = std::move(next);
+                }
+                acc = acc.value ? combine(std::move(acc), std::move(level[0])) : std::move(level[0]);
+                start = end;
+            }
+            if (constant != identity(op) || !acc.value) {
+                Operand c{std::make_unique<IntergerValue>(constant), 0, 0};
+                acc = acc.value ? combine(std::move(acc), std::move(c)) : std::move(c);
+            }
+
+            if (const_count < 2 && acc.height >= old_height && !mixed_ranks) {
+                continue;
+            }
+            if (seq.empty()) {
+                // 只剩一个值：root 变为它的复制
+                int type = acc.value->v_tag == IRValueTag::INTEGER ? 1 : 0;
+                seq.push_back(std::make_unique<LoadValue>(bin->name, std::move(acc.value), type));
+            } else {
+                seq.back()->name = bin->name;
+            }
+            for (int i : interior) {
+                removed[i] = true;
+            }
+            rewritten[root] = std::move(seq);
+        }
+        if (rewritten.empty()) {
+            continue;
+        }
+
+        std::vector<std::unique_ptr<IRValue>> new_insts;
+        for (int i = 0; i < m; i++) {
+            auto it = rewritten.find(i);
+            if (it != rewritten.end()) {
+                for (auto& inst : it->second) {
+                    new_insts.push_back(std::move(inst));
+                }
+            } else if (!removed[i]) {
+                new_insts.push_back(std::move(insts[i]));
+            }
+        }
+        insts = std::move(new_insts);
+    }
+}
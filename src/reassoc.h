@@ -0,0 +1,30 @@
+#ifndef REASSOC_H
+#define REASSOC_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 重结合与树高压缩：同一块中同一种可结合、可交换运算（+ * & | ^）组成的表达式树，
+// 中间结果只被树中的上一层使用，展开成叶子的列表后重新组合：
+// 1. 所有常量叶子合并成一个，放在最后一次运算的右边（可以使用立即数形式）；
+// 2. 叶子按所在循环深度排序（变量取 store 它的最深循环），循环不变的部分先组合成子树，
+//    便于之后的 PRE 把它提到循环外；
+// 3. 同一深度的叶子组合成平衡树，左链 a+b+c+d 的三级依赖变为两级，双发射的核心可以并行执行。
+class ReassociationOptimizer {
+public:
+    ReassociationOptimizer() = default;
+
+    void optimize(Program* program);
+
+private:
+    void optimize_function(Function* func);
+
+    std::string generate_temp_name();
+
+    static int temp_counter;
+};
+
+#endif // REASSOC_H
@@ -0,0 +1,284 @@
+#include "rv_lowering.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+static const TargetLatency target_latencies[] = {
+    // pipelined multiplier, iterative divider
+    {"generic", 1, 3, 4, 34, 10},
+    // iterative multiplier and divider, short pipeline, e.g. small embedded cores
+    {"small", 1, 32, 32, 34, 3},
+    // fast multiplier and a radix-4 divider
+    {"fast-div", 1, 3, 3, 12, 10},
+};
+
+const TargetLatency &current_target() {
+    for (const auto &target : target_latencies) {
+        if (strcmp(target.name, TOYC_TARGET) == 0) {
+            return target;
+        }
+    }
+    throw std::runtime_error(std::string("Unknown target: ") + TOYC_TARGET);
+}
+
+namespace {
+
+// an instruction sequence together with its latency on the current target
+struct Seq {
+    std::vector<std::string> insts;
+    int cost = 0;
+
+    void alu(const std::string &inst) {
+        insts.push_back(inst);
+        cost += current_target().alu;
+    }
+
+    void other(const std::string &inst, int latency) {
+        insts.push_back(inst);
+        cost += latency;
+    }
+
+    // li takes one instruction when the value fits in 12 bits, lui + addi otherwise
+    void li(const std::string &reg, int32_t value) {
+        insts.push_back("li " + reg + ", " + std::to_string(value));
+        cost += current_target().alu * ((value >= -2048 && value < 2048) ? 1 : 2);
+    }
+
+    void append(const Seq &other) {
+        insts.insert(insts.end(), other.insts.begin(), other.insts.end());
+        cost += other.cost;
+    }
+
+    void emit(std::ostringstream &oss) const {
+        for (const auto &inst : insts) {
+            oss << "  " << inst << "\n";
+        }
+    }
+};
+
+bool is_power_of_two(uint32_t x) {
+    return x != 0 && (x & (x - 1)) == 0;
+}
+
+int log2_exact(uint32_t x) {
+    int k = 0;
+    while ((x >> k) != 1) {
+        k++;
+    }
+    return k;
+}
+
+// the plain instruction with the constant materialized in t3
+Seq plain(const std::string &op, const std::string &src, const std::string &dst, int c, int latency) {
+    Seq seq;
+    seq.li("t3", c);
+    seq.other(op + " " + dst + ", " + src + ", t3", latency);
+    return seq;
+}
+
+// dst = src * c as shifts and adds, using the non-adjacent form of c
+Seq mul_shift_add(const std::string &src, const std::string &dst, int c) {
+    Seq seq;
+    if (c == 0) {
+        seq.alu("li " + dst + ", 0");
+        return seq;
+    }
+
+    // terms of c = sum(sign * 2^shift), with no two adjacent non-zero digits
+    std::vector<std::pair<int, int>> terms;
+    uint64_t u = static_cast<uint32_t>(c);
+    for (int i = 0; u != 0 && i < 32; i++, u >>= 1) {
+        if (u & 1) {
+            int digit = 2 - static_cast<int>(u & 3);
+            terms.push_back({i, digit});
+            u = digit == 1 ? u - 1 : u + 1;
+        }
+    }
+
+    // start from a positive term if there is one, otherwise negate at the end
+    bool all_negative = true;
+    for (size_t i = 0; i < terms.size(); i++) {
+        if (terms[i].second > 0) {
+            std::swap(terms[0], terms[i]);
+            all_negative = false;
+            break;
+        }
+    }
+
+    std::string acc = src;
+    if (terms[0].first > 0) {
+        seq.alu("slli " + dst + ", " + src + ", " + std::to_string(terms[0].first));
+        acc = dst;
+    }
+    for (size_t i = 1; i < terms.size(); i++) {
+        std::string operand = src;
+        if (terms[i].first > 0) {
+            seq.alu("slli t3, " + src + ", " + std::to_string(terms[i].first));
+            operand = "t3";
+        }
+        bool add = all_negative || terms[i].second > 0;
+        seq.alu(std::string(add ? "add " : "sub ") + dst + ", " + acc + ", " + operand);
+        acc = dst;
+    }
+    if (all_negative) {
+        seq.alu("neg " + dst + ", " + acc);
+    } else if (acc != dst) {
+        seq.alu("mv " + dst + ", " + acc);
+    }
+    return seq;
+}
+
+// magic number for signed division by d, 2 <= |d|, see Hacker's Delight 10-1
+void signed_magic(int32_t d, int32_t &magic, int &shift) {
+    const uint32_t two31 = 0x80000000u;
+    uint32_t ad = d < 0 ? 0u - static_cast<uint32_t>(d) : static_cast<uint32_t>(d);
+    uint32_t t = two31 + (static_cast<uint32_t>(d) >> 31);
+    uint32_t anc = t - 1 - t % ad;
+    int p = 31;
+    uint32_t q1 = two31 / anc, r1 = two31 - q1 * anc;
+    uint32_t q2 = two31 / ad, r2 = two31 - q2 * ad;
+    uint32_t delta;
+    do {
+        p++;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc) {
+            q1++;
+            r1 -= anc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= ad) {
+            q2++;
+            r2 -= ad;
+        }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+    uint32_t m = q2 + 1;
+    magic = static_cast<int32_t>(d < 0 ? 0u - m : m);
+    shift = p - 32;
+}
+
+// signed dst = src / d without div, d not in {0, 1, -1}
+Seq div_sequence(const std::string &src, const std::string &dst, int32_t d) {
+    Seq seq;
+    uint32_t ad = d < 0 ? 0u - static_cast<uint32_t>(d) : static_cast<uint32_t>(d);
+
+    if (is_power_of_two(ad)) {
+        // round towards zero: add 2^k - 1 to negative dividends before the arithmetic shift
+        int k = log2_exact(ad);
+        if (k == 1) {
+            seq.alu("srli t3, " + src + ", 31");
+        } else {
+            seq.alu("srai t3, " + src + ", 31");
+            seq.alu("srli t3, t3, " + std::to_string(32 - k));
+        }
+        seq.alu("add t3, " + src + ", t3");
+        seq.alu("srai " + dst + ", t3, " + std::to_string(k));
+        if (d < 0) {
+            seq.alu("neg " + dst + ", " + dst);
+        }
+        return seq;
+    }
+
+    int32_t magic;
+    int shift;
+    signed_magic(d, magic, shift);
+    seq.li("t3", magic);
+    seq.other("mulh " + dst + ", " + src + ", t3", current_target().mulh);
+    if (d > 0 && magic < 0) {
+        seq.alu("add " + dst + ", " + dst + ", " + src);
+    } else if (d < 0 && magic > 0) {
+        seq.alu("sub " + dst + ", " + dst + ", " + src);
+    }
+    if (shift > 0) {
+        seq.alu("srai " + dst + ", " + dst + ", " + std::to_string(shift));
+    }
+    // add one to negative quotients
+    seq.alu("srli t3, " + dst + ", 31");
+    seq.alu("add " + dst + ", " + dst + ", t3");
+    return seq;
+}
+
+// signed dst = src % d without rem, d not in {0, 1, -1}
+Seq rem_sequence(const std::string &src, const std::string &dst, int32_t d) {
+    Seq seq;
+    uint32_t ad = d < 0 ? 0u - static_cast<uint32_t>(d) : static_cast<uint32_t>(d);
+
+    if (is_power_of_two(ad)) {
+        // the remainder takes the sign of the dividend, so src % d == src % |d|
+        int k = log2_exact(ad);
+        if (k == 1) {
+            seq.alu("srli t3, " + src + ", 31");
+        } else {
+            seq.alu("srai t3, " + src + ", 31");
+            seq.alu("srli t3, t3, " + std::to_string(32 - k));
+        }
+        seq.alu("add t3, " + src + ", t3");
+        int32_t mask = static_cast<int32_t>(0u - ad);
+        if (k <= 11) {
+            seq.alu("andi t3, t3, " + std::to_string(mask));
+        } else {
+            seq.li("t4", mask);
+            seq.alu("and t3, t3, t4");
+        }
+        seq.alu("sub " + dst + ", " + src + ", t3");
+        return seq;
+    }
+
+    // src - (src / d) * d
+    seq.append(div_sequence(src, "t4", d));
+    Seq product = mul_shift_add("t4", dst, d);
+    Seq product_mul = plain("mul", "t4", dst, d, current_target().mul);
+    seq.append(product.cost < product_mul.cost ? product : product_mul);
+    seq.alu("sub " + dst + ", " + src + ", " + dst);
+    return seq;
+}
+
+} // namespace
+
+bool lower_mul_const(std::ostringstream &oss, const std::string &src, const std::string &dst, int c) {
+    Seq seq = mul_shift_add(src, dst, c);
+    if (seq.cost >= plain("mul", src, dst, c, current_target().mul).cost) {
+        return false;
+    }
+    seq.emit(oss);
+    return true;
+}
+
+bool lower_div_const(std::ostringstream &oss, const std::string &src, const std::string &dst, int c) {
+    Seq seq;
+    if (c == 0) {
+        return false; // keep the division by zero semantics of div
+    } else if (c == 1) {
+        seq.alu("mv " + dst + ", " + src);
+    } else if (c == -1) {
+        seq.alu("neg " + dst + ", " + src);
+    } else {
+        seq = div_sequence(src, dst, c);
+        if (seq.cost >= plain("div", src, dst, c, current_target().div).cost) {
+            return false;
+        }
+    }
+    seq.emit(oss);
+    return true;
+}
+
+bool lower_rem_const(std::ostringstream &oss, const std::string &src, const std::string &dst, int c) {
+    Seq seq;
+    if (c == 0) {
+        return false;
+    } else if (c == 1 || c == -1) {
+        seq.alu("li " + dst + ", 0");
+    } else {
+        seq = rem_sequence(src, dst, c);
+        if (seq.cost >= plain("rem", src, dst, c, current_target().div).cost) {
+            return false;
+        }
+    }
+    seq.emit(oss);
+    return true;
+}
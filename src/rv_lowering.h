@@ -0,0 +1,41 @@
+/** Strength reduction of multiply/divide/modulo by constants for RV32IM. */
+#ifndef RV_LOWERING_H
+#define RV_LOWERING_H
+
+#include <sstream>
+#include <string>
+
+// Latency (in cycles) of the instruction classes we choose between.
+struct TargetLatency {
+    const char *name;
+    int alu;  // add/sub/shift/logic/li, per instruction
+    int mul;  // mul
+    int mulh; // mulh
+    int div;  // div/rem
+    int branch_miss; // branch mispredict penalty
+};
+
+// The target is chosen at build time, e.g. CXXFLAGS += -DTOYC_TARGET=\"small\".
+#ifndef TOYC_TARGET
+#define TOYC_TARGET "generic"
+#endif
+
+// Zicond (czero.eqz/czero.nez) is available, e.g. CXXFLAGS += -DTOYC_ZICOND.
+#ifdef TOYC_ZICOND
+constexpr bool target_has_zicond = true;
+#else
+constexpr bool target_has_zicond = false;
+#endif
+
+const TargetLatency &current_target();
+
+// Each function emits code computing `dst = src op c` and returns true, or emits nothing and
+// returns false when the plain mul/div/rem instruction is cheaper on the current target.
+// src and dst must differ; t3 and t4 are used as scratch registers.
+bool lower_mul_const(std::ostringstream &oss, const std::string &src, const std::string &dst, int c);
+
+bool lower_div_const(std::ostringstream &oss, const std::string &src, const std::string &dst, int c);
+
+bool lower_rem_const(std::ostringstream &oss, const std::string &src, const std::string &dst, int c);
+
+#endif // RV_LOWERING_H
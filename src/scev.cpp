@@ -0,0 +1,750 @@
+#include "scev.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+int ScalarEvolutionOptimizer::temp_counter = 0;
+
+namespace {
+
+// 仿射表达式 c + Σ coef * atom，运算按 2^32 取模（与 RV32 的回绕语义一致）
+// atom 为循环变量在本轮迭代开始时的值，或者循环不变量
+struct Affine {
+    std::map<std::string, uint32_t> terms;
+    uint32_t c = 0;
+
+    bool is_const() const { return terms.empty(); }
+
+    uint32_t coef(const std::string& atom) const {
+        auto it = terms.find(atom);
+        return it == terms.end() ? 0 : it->second;
+    }
+};
+
+// 无法表示为仿射表达式的值用 nullopt 表示
+using SymVal = std::optional<Affine>;
+
+Affine make_const(uint32_t c) {
+    Affine a;
+    a.c = c;
+    return a;
+}
+
+Affine make_atom(const std::string& name) {
+    Affine a;
+    a.terms[name] = 1;
+    return a;
+}
+
+// a + k * b
+Affine add_scaled(const Affine& a, const Affine& b, uint32_t k) {
+    Affine r = a;
+    r.c += k * b.c;
+    for (const auto& [name, coef] : b.terms) {
+        uint32_t v = r.terms[name] + k * coef;
+        if (v == 0) {
+            r.terms.erase(name);
+        } else {
+            r.terms[name] = v;
+        }
+    }
+    return r;
+}
+
+// 加法递推
+struct Recurrence {
+    int kind;       // 1: 一阶 {v0, +, step}; 2: 二阶 {v0, +, inc0, +, inc1}; 3: 每轮重新计算的派生值
+    Affine step;    // kind 1，只含循环不变量
+    Affine inc0;    // kind 2，第 0 轮的增量，循环变量 atom 表示其初值
+    Affine inc1;    // kind 2，增量每轮的变化量，只含循环不变量
+    Affine expr;    // kind 3，本轮结束时的值，atom 为本轮开始时的值
+};
+
+// 闭式计算中的操作数：常量或变量名
+struct Operand {
+    bool is_const;
+    uint32_t c;
+    std::string name;
+};
+
+Operand const_op(uint32_t c) { return {true, c, ""}; }
+
+Operand var_op(const std::string& name) { return {false, 0, name}; }
+
+std::unique_ptr<IRValue> to_value(const Operand& op) {
+    if (op.is_const) {
+        return std::make_unique<IntergerValue>(static_cast<int>(op.c));
+    }
+    return std::make_unique<VarRefValue>(op.name);
+}
+
+// 向指令序列追加闭式计算，常量和单位元就地化简
+struct Emitter {
+    std::vector<std::unique_ptr<IRValue>>& out;
+    std::function<std::string()> fresh;
+
+    Operand bin(BinaryOp op, Operand a, Operand b) {
+        if (a.is_const && b.is_const) {
+            int32_t sa = static_cast<int32_t>(a.c), sb = static_cast<int32_t>(b.c);
+            switch (op) {
+                case BinaryOp::ADD: return const_op(a.c + b.c);
+                case BinaryOp::SUB: return const_op(a.c - b.c);
+                case BinaryOp::MUL: return const_op(a.c * b.c);
+                case BinaryOp::AND: return const_op(a.c & b.c);
+                case BinaryOp::SHR: return const_op(a.c >> (b.c & 31));
+                case BinaryOp::EQ: return const_op(sa == sb);
+                case BinaryOp::NE: return const_op(sa != sb);
+                case BinaryOp::GT: return const_op(sa > sb);
+                case BinaryOp::GE: return const_op(sa >= sb);
+                default: break;
+            }
+        }
+        if (op == BinaryOp::ADD && a.is_const && a.c == 0) return b;
+        if ((op == BinaryOp::ADD || op == BinaryOp::SUB) && b.is_const && b.c == 0) return a;
+        if (op == BinaryOp::MUL) {
+            if (a.is_const) std::swap(a, b);
+            if (b.is_const && b.c == 0) return const_op(0);
+            if (b.is_const && b.c == 1) return a;
+        }
+        if (op == BinaryOp::AND && ((a.is_const && a.c == 0) || (b.is_const && b.c == 0))) {
+            return const_op(0);
+        }
+
+        std::string name = fresh();
+        out.push_back(std::make_unique<BinaryValue>(name, op, to_value(a), to_value(b)));
+        return var_op(name);
+    }
+
+    Operand load(const std::string& var) {
+        std::string name = fresh();
+        out.push_back(std::make_unique<LoadValue>(name, std::make_unique<VarRefValue>(var)));
+        return var_op(name);
+    }
+
+    void store(const Operand& value, const std::string& var) {
+        out.push_back(std::make_unique<StoreValue>(to_value(value), std::make_unique<VarRefValue>(var)));
+    }
+
+    // c + Σ coef * atom
+    Operand affine(const Affine& a, const std::function<Operand(const std::string&)>& resolve) {
+        Operand acc = const_op(a.c);
+        for (const auto& [atom, coef] : a.terms) {
+            Operand v = resolve(atom);
+            if (coef == UINT32_MAX) {
+                acc = bin(BinaryOp::SUB, acc, v);
+            } else {
+                acc = bin(BinaryOp::ADD, acc, bin(BinaryOp::MUL, v, const_op(coef)));
+            }
+        }
+        return acc;
+    }
+
+    // k * (k - 1) / 2 = (k >> 1) * (k - 1 + (k & 1))，在模 2^32 下精确
+    Operand triangle(Operand k) {
+        Operand half = bin(BinaryOp::SHR, k, const_op(1));
+        Operand odd = bin(BinaryOp::AND, k, const_op(1));
+        Operand rest = bin(BinaryOp::ADD, bin(BinaryOp::SUB, k, const_op(1)), odd);
+        return bin(BinaryOp::MUL, half, rest);
+    }
+};
+
+// 初值、界和步长都是常量时直接算出循环次数
+// 要求循环变量在退出前不溢出，否则放弃
+bool const_trip_count(BinaryOp op, int64_t i0, int64_t bound, int64_t step, int64_t& k) {
+    switch (op) {
+        case BinaryOp::LT:
+            if (!(i0 < bound)) { k = 0; return true; }
+            if (step <= 0) return false;
+            k = (bound - i0 + step - 1) / step;
+            break;
+        case BinaryOp::LE:
+            if (!(i0 <= bound)) { k = 0; return true; }
+            if (step <= 0) return false;
+            k = (bound - i0) / step + 1;
+            break;
+        case BinaryOp::GT:
+            if (!(i0 > bound)) { k = 0; return true; }
+            if (step >= 0) return false;
+            k = (i0 - bound - step - 1) / -step;
+            break;
+        case BinaryOp::GE:
+            if (!(i0 >= bound)) { k = 0; return true; }
+            if (step >= 0) return false;
+            k = (i0 - bound) / -step + 1;
+            break;
+        case BinaryOp::NE:
+            if (i0 == bound) { k = 0; return true; }
+            if ((bound - i0) % step != 0 || (bound - i0) / step <= 0) return false;
+            k = (bound - i0) / step;
+            break;
+        case BinaryOp::EQ:
+            k = (i0 == bound) ? 1 : 0;
+            return true;
+        default:
+            return false;
+    }
+    int64_t last = i0 + k * step;
+    return last >= INT32_MIN && last <= INT32_MAX;
+}
+
+} // namespace
+
+std::string ScalarEvolutionOptimizer::generate_temp_name() {
+    std::ostringstream oss;
+    oss << "%scev_" << temp_counter++;
+    return oss.str();
+}
+
+void ScalarEvolutionOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+void ScalarEvolutionOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+
+    // 每次变换后重新分析，内层循环先处理
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        CFG cfg = build_cfg(func);
+        auto idom = compute_idom(cfg);
+        auto loops = find_loops(cfg, idom);
+        for (const auto& loop : loops) {
+            if (transform_loop(func, cfg, loop)) {
+                changed = true;
+                break;
+            }
+        }
+    }
+}
+
+bool ScalarEvolutionOptimizer::transform_loop(Function* func, const CFG& cfg, const Loop& loop) {
+    auto& bbs = func->bbs;
+    int header = loop.header;
+    if (loop.latches.size() != 1 || bbs[header]->insts.empty()) {
+        return false;
+    }
+
+    // 循环头以 br 结尾：真分支进入循环体，假分支离开循环
+    auto* br = dynamic_cast<BranchValue*>(bbs[header]->insts.back().get());
+    if (!br || !cfg.index.count(br->true_block) || !cfg.index.count(br->false_block)) {
+        return false;
+    }
+    int body = cfg.index.at(br->true_block);
+    int exit = cfg.index.at(br->false_block);
+    if (body == header || !loop.blocks.count(body) || loop.blocks.count(exit)) {
+        return false;
+    }
+
+    // 唯一的循环外前驱，以 jump 进入循环
+    int pre = -1;
+    for (int p : cfg.preds[header]) {
+        if (loop.blocks.count(p)) {
+            continue;
+        }
+        if (pre != -1) {
+            return false;
+        }
+        pre = p;
+    }
+    if (pre == -1 || bbs[pre]->insts.empty() || bbs[pre]->insts.back()->v_tag != IRValueTag::JUMP) {
+        return false;
+    }
+
+    // 循环体必须是一条以 jump 相连、回到循环头的直线链，循环只从循环头退出
+    std::vector<int> chain = {header};
+    int cur = body;
+    while (cur != header) {
+        if (!loop.blocks.count(cur) || std::find(chain.begin(), chain.end(), cur) != chain.end() ||
+            bbs[cur]->insts.empty()) {
+            return false;
+        }
+        chain.push_back(cur);
+        auto* jump = dynamic_cast<JumpValue*>(bbs[cur]->insts.back().get());
+        if (!jump || !cfg.index.count(jump->target_block)) {
+            return false;
+        }
+        cur = cfg.index.at(jump->target_block);
+    }
+    if (chain.size() != loop.blocks.size()) {
+        return false;
+    }
+
+    // 收集循环内的定义；含调用的循环不处理，循环头只允许无副作用的计算
+    std::unordered_set<std::string> loop_defs;
+    std::set<std::string> vars;                   // 循环中被 store 的变量
+    std::unordered_set<std::string> local_vars;   // 循环体内声明的变量，循环后不可见
+    for (int b : chain) {
+        for (const auto& inst : bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::CALL) {
+                return false;
+            }
+            if (inst->v_tag == IRValueTag::STORE) {
+                if (b == header) {
+                    return false;
+                }
+                vars.insert(get_def(inst.get()));
+            }
+            if (inst->v_tag == IRValueTag::ALLOC) {
+                local_vars.insert(inst->name);
+            }
+            std::string def = get_def(inst.get());
+            if (!def.empty()) {
+                loop_defs.insert(def);
+            }
+        }
+    }
+
+    // 符号执行一轮迭代
+    std::unordered_map<std::string, SymVal> env;
+    std::unordered_map<std::string, std::set<std::string>> deps;   // 值依赖的循环变量
+    std::map<std::string, std::set<std::string>> store_deps;
+    std::set<std::string> cond_deps;
+    struct Compare {
+        BinaryOp op;
+        SymVal lhs, rhs;
+    };
+    std::unordered_map<std::string, Compare> compares;
+    bool used_before_def = false;
+
+    for (const auto& v : vars) {
+        env[v] = make_atom(v);
+        deps[v] = {v};
+    }
+
+    auto value_of = [&](const IRValue* v) -> SymVal {
+        if (v->v_tag == IRValueTag::INTEGER) {
+            return make_const(static_cast<uint32_t>(static_cast<const IntergerValue*>(v)->value));
+        }
+        auto it = env.find(v->name);
+        if (it != env.end()) {
+            return it->second;
+        }
+        if (loop_defs.count(v->name)) {
+            used_before_def = true;
+            return std::nullopt;
+        }
+        return make_atom(v->name);
+    };
+    auto deps_of = [&](const IRValue* v) -> std::set<std::string> {
+        auto it = deps.find(v->name);
+        return it == deps.end() ? std::set<std::string>() : it->second;
+    };
+
+    for (int b : chain) {
+        for (const auto& inst : bbs[b]->insts) {
+            switch (inst->v_tag) {
+                case IRValueTag::ALLOC:
+                    env[inst->name] = std::nullopt;
+                    deps[inst->name].clear();
+                    break;
+                case IRValueTag::LOAD: {
+                    auto* ld = static_cast<LoadValue*>(inst.get());
+                    env[ld->name] = value_of(ld->src.get());
+                    deps[ld->name] = deps_of(ld->src.get());
+                    break;
+                }
+                case IRValueTag::STORE: {
+                    auto* st = static_cast<StoreValue*>(inst.get());
+                    const std::string& dest = st->dest->name;
+                    env[dest] = value_of(st->value.get());
+                    deps[dest] = deps_of(st->value.get());
+                    store_deps[dest].insert(deps[dest].begin(), deps[dest].end());
+                    break;
+                }
+                case IRValueTag::BINARY: {
+                    auto* bin = static_cast<BinaryValue*>(inst.get());
+                    SymVal l = value_of(bin->lhs.get());
+                    SymVal r = value_of(bin->rhs.get());
+                    SymVal res;
+                    if (l && r) {
+                        if (bin->op == BinaryOp::ADD) {
+                            res = add_scaled(*l, *r, 1);
+                        } else if (bin->op == BinaryOp::SUB) {
+                            res = add_scaled(*l, *r, UINT32_MAX);
+                        } else if (bin->op == BinaryOp::MUL && l->is_const()) {
+                            res = add_scaled(make_const(0), *r, l->c);
+                        } else if (bin->op == BinaryOp::MUL && r->is_const()) {
+                            res = add_scaled(make_const(0), *l, r->c);
+                        } else if (bin->op == BinaryOp::SHL && r->is_const() && r->c < 32) {
+                            res = add_scaled(make_const(0), *l, 1u << r->c);
+                        }
+                    }
+                    if (is_compare(bin->op)) {
+                        compares[bin->name] = {bin->op, l, r};
+                    }
+                    env[bin->name] = res;
+                    auto d = deps_of(bin->lhs.get());
+                    auto rd = deps_of(bin->rhs.get());
+                    d.insert(rd.begin(), rd.end());
+                    deps[bin->name] = d;
+                    break;
+                }
+                case IRValueTag::BRANCH:
+                    value_of(static_cast<BranchValue*>(inst.get())->cond.get());
+                    cond_deps = deps_of(static_cast<BranchValue*>(inst.get())->cond.get());
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    if (used_before_def) {
+        return false;
+    }
+
+    auto is_invariant = [&](const Affine& a) {
+        for (const auto& [atom, coef] : a.terms) {
+            if (vars.count(atom)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // 识别递推：先一阶，再二阶，最后派生值
+    std::map<std::string, Recurrence> recs;
+    std::vector<std::string> candidates;
+    for (const auto& v : vars) {
+        if (!local_vars.count(v) && env[v]) {
+            candidates.push_back(v);
+        }
+    }
+    for (const auto& v : candidates) {
+        const Affine& next = *env[v];
+        if (next.coef(v) != 1) {
+            continue;
+        }
+        Affine inc = add_scaled(next, make_atom(v), UINT32_MAX);
+        if (is_invariant(inc)) {
+            Recurrence rec;
+            rec.kind = 1;
+            rec.step = inc;
+            recs[v] = rec;
+        }
+    }
+    for (const auto& v : candidates) {
+        const Affine& next = *env[v];
+        if (recs.count(v) || next.coef(v) != 1) {
+            continue;
+        }
+        Affine inc = add_scaled(next, make_atom(v), UINT32_MAX);
+        Recurrence rec;
+        rec.kind = 2;
+        rec.inc0 = inc;
+        bool ok = true;
+        for (const auto& [atom, coef] : inc.terms) {
+            if (!vars.count(atom)) {
+                continue;
+            }
+            auto it = recs.find(atom);
+            if (it == recs.end() || it->second.kind != 1) {
+                ok = false;
+                break;
+            }
+            rec.inc1 = add_scaled(rec.inc1, it->second.step, coef);
+        }
+        if (ok) {
+            recs[v] = rec;
+        }
+    }
+    for (const auto& v : candidates) {
+        const Affine& next = *env[v];
+        if (recs.count(v) || next.coef(v) != 0) {
+            continue;
+        }
+        bool ok = true;
+        for (const auto& [atom, coef] : next.terms) {
+            if (vars.count(atom) && (!recs.count(atom) || recs[atom].kind == 3)) {
+                ok = false;
+                break;
+            }
+        }
+        if (ok) {
+            Recurrence rec;
+            rec.kind = 3;
+            rec.expr = next;
+            recs[v] = rec;
+        }
+    }
+
+    // 退出条件：iv op bound，iv 为常量步长的一阶递推，bound 为循环不变量
+    const std::string& cond_name = br->cond->name;
+    Compare cmp;
+    if (compares.count(cond_name)) {
+        cmp = compares[cond_name];
+    } else if (env.count(cond_name)) {
+        cmp = {BinaryOp::NE, env[cond_name], make_const(0)};
+    } else {
+        return false;
+    }
+    if (!cmp.lhs || !cmp.rhs) {
+        return false;
+    }
+    auto as_iv = [&](const Affine& a) -> std::string {
+        if (a.c != 0 || a.terms.size() != 1 || a.terms.begin()->second != 1) {
+            return "";
+        }
+        const std::string& atom = a.terms.begin()->first;
+        auto it = recs.find(atom);
+        if (it == recs.end() || it->second.kind != 1 || !it->second.step.is_const() ||
+            it->second.step.c == 0) {
+            return "";
+        }
+        return atom;
+    };
+    std::string iv;
+    BinaryOp cmp_op = cmp.op;
+    Affine bound;
+    if (!(iv = as_iv(*cmp.lhs)).empty() && is_invariant(*cmp.rhs)) {
+        bound = *cmp.rhs;
+    } else if (!(iv = as_iv(*cmp.rhs)).empty() && is_invariant(*cmp.lhs)) {
+        bound = *cmp.lhs;
+        cmp_op = swap_compare(cmp_op);
+    } else {
+        return false;
+    }
+    int32_t step = static_cast<int32_t>(recs[iv].step.c);
+
+    // 循环变量的初值是否为常量（预备块中最后一次 store 的值）
+    bool has_iv_init = false;
+    int32_t iv_init = 0;
+    for (const auto& inst : bbs[pre]->insts) {
+        if (inst->v_tag == IRValueTag::STORE && get_def(inst.get()) == iv) {
+            auto* st = static_cast<StoreValue*>(inst.get());
+            has_iv_init = st->value->v_tag == IRValueTag::INTEGER;
+            if (has_iv_init) {
+                iv_init = static_cast<IntergerValue*>(st->value.get())->value;
+            }
+        }
+    }
+    bool const_trip = has_iv_init && bound.is_const();
+    int64_t const_k = 0;
+    if (const_trip) {
+        if (!const_trip_count(cmp_op, iv_init, static_cast<int32_t>(bound.c), step, const_k)) {
+            return false;
+        }
+    } else if (cmp_op != BinaryOp::EQ &&
+               !(step == 1 && (cmp_op == BinaryOp::LT || cmp_op == BinaryOp::LE || cmp_op == BinaryOp::NE)) &&
+               !(step == -1 && (cmp_op == BinaryOp::GT || cmp_op == BinaryOp::GE || cmp_op == BinaryOp::NE))) {
+        return false;
+    } else if ((cmp_op == BinaryOp::LE && !(bound.is_const() && static_cast<int32_t>(bound.c) != INT32_MAX)) ||
+               (cmp_op == BinaryOp::GE && !(bound.is_const() && static_cast<int32_t>(bound.c) != INT32_MIN))) {
+        // i <= INT32_MAX / i >= INT32_MIN 恒成立，循环不终止，|bound - i0| + 1 也会溢出
+        return false;
+    }
+
+    // 闭式计算：init 给出循环变量进入循环时的值
+    auto emit_closed_forms = [&](Emitter& em, const std::function<Operand(const std::string&)>& init,
+                                 const std::vector<std::string>& targets) {
+        auto resolve_init = [&](const std::string& atom) {
+            return vars.count(atom) ? init(atom) : var_op(atom);
+        };
+
+        Operand k;
+        Operand i0 = init(iv);
+        Operand b = em.affine(bound, resolve_init);
+        if (const_trip) {
+            k = const_op(static_cast<uint32_t>(const_k));
+        } else if (cmp_op == BinaryOp::EQ) {
+            k = em.bin(BinaryOp::EQ, i0, b);
+        } else if (cmp_op == BinaryOp::NE) {
+            k = step == 1 ? em.bin(BinaryOp::SUB, b, i0) : em.bin(BinaryOp::SUB, i0, b);
+        } else {
+            // 循环至少执行一次时为 |bound - i0| (+1)，否则为 0
+            Operand d, c;
+            if (step == 1) {
+                d = em.bin(BinaryOp::SUB, b, i0);
+                c = em.bin(cmp_op == BinaryOp::LT ? BinaryOp::GT : BinaryOp::GE, b, i0);
+            } else {
+                d = em.bin(BinaryOp::SUB, i0, b);
+                c = em.bin(cmp_op == BinaryOp::GT ? BinaryOp::GT : BinaryOp::GE, i0, b);
+            }
+            if (cmp_op == BinaryOp::LE || cmp_op == BinaryOp::GE) {
+                d = em.bin(BinaryOp::ADD, d, const_op(1));
+            }
+            k = em.bin(BinaryOp::AND, d, em.bin(BinaryOp::SUB, const_op(0), c));
+        }
+
+        // 递推变量在第 t 轮开始时的值
+        std::function<Operand(const std::string&, Operand)> value_at = [&](const std::string& v, Operand t) {
+            const Recurrence& rec = recs.at(v);
+            if (rec.kind == 1) {
+                return em.bin(BinaryOp::ADD, init(v),
+                              em.bin(BinaryOp::MUL, t, em.affine(rec.step, resolve_init)));
+            }
+            Operand linear = em.bin(BinaryOp::MUL, t, em.affine(rec.inc0, resolve_init));
+            Operand quad = em.bin(BinaryOp::MUL, em.triangle(t), em.affine(rec.inc1, resolve_init));
+            return em.bin(BinaryOp::ADD, init(v), em.bin(BinaryOp::ADD, linear, quad));
+        };
+
+        std::vector<std::pair<std::string, Operand>> results;
+        for (const auto& v : targets) {
+            const Recurrence& rec = recs.at(v);
+            if (rec.kind != 3) {
+                results.push_back({v, value_at(v, k)});
+                continue;
+            }
+            // 派生值：循环至少执行一次时取最后一轮算出的值，否则保持初值
+            Operand last_iter = em.bin(BinaryOp::SUB, k, const_op(1));
+            Operand last = em.affine(rec.expr, [&](const std::string& atom) {
+                return vars.count(atom) ? value_at(atom, last_iter) : var_op(atom);
+            });
+            Operand mask = em.bin(BinaryOp::SUB, const_op(0), em.bin(BinaryOp::NE, k, const_op(0)));
+            Operand diff = em.bin(BinaryOp::AND, em.bin(BinaryOp::SUB, last, init(v)), mask);
+            results.push_back({v, em.bin(BinaryOp::ADD, init(v), diff)});
+        }
+        for (const auto& [v, value] : results) {
+            em.store(value, v);
+        }
+    };
+
+    // 1. 循环内定义的值在循环外都用不到时，用闭式计算替换整个循环
+    bool all_recurrences = true;
+    for (const auto& v : vars) {
+        if (!local_vars.count(v) && !recs.count(v)) {
+            all_recurrences = false;
+        }
+    }
+    bool escapes = false;
+    std::unordered_set<int> in_chain(chain.begin(), chain.end());
+    for (int b = 0; b < static_cast<int>(bbs.size()) && !escapes; b++) {
+        if (in_chain.count(b)) {
+            continue;
+        }
+        for (const auto& inst : bbs[b]->insts) {
+            for (auto* op : get_operands(inst.get())) {
+                const std::string& name = (*op)->name;
+                if (loop_defs.count(name) && (!vars.count(name) || local_vars.count(name))) {
+                    escapes = true;
+                }
+            }
+        }
+    }
+
+    if (all_recurrences && !escapes) {
+        std::vector<std::unique_ptr<IRValue>> code;
+        Emitter em{code, [this]() { return generate_temp_name(); }};
+        std::map<std::string, Operand> init_values;
+        std::vector<std::string> targets;
+        for (const auto& v : vars) {
+            if (!local_vars.count(v)) {
+                init_values[v] = em.load(v);
+                targets.push_back(v);
+            }
+        }
+        emit_closed_forms(em, [&](const std::string& v) { return init_values.at(v); }, targets);
+        code.push_back(std::make_unique<JumpValue>(br->false_block));
+        bbs[header]->insts = std::move(code);
+
+        std::vector<std::unique_ptr<BasicBlock>> new_bbs;
+        for (int b = 0; b < static_cast<int>(bbs.size()); b++) {
+            if (b == header || !in_chain.count(b)) {
+                new_bbs.push_back(std::move(bbs[b]));
+            }
+        }
+        bbs = std::move(new_bbs);
+        return true;
+    }
+
+    // 2. 只服务于自身更新的递推变量移出循环，出口处赋闭式值
+    if (cfg.preds[exit].size() != 1) {
+        return false;
+    }
+    std::vector<std::string> removable;
+    for (const auto& [v, rec] : recs) {
+        if (v == iv || cond_deps.count(v)) {
+            continue;
+        }
+        bool used_by_others = false;
+        for (const auto& [x, d] : store_deps) {
+            if (x != v && !local_vars.count(x) && d.count(v)) {
+                used_by_others = true;
+            }
+        }
+        if (!used_by_others) {
+            removable.push_back(v);
+        }
+    }
+    if (removable.empty()) {
+        return false;
+    }
+
+    // 需要在进入循环前保存初值的变量
+    std::set<std::string> snapshot;
+    std::function<void(const std::string&)> need = [&](const std::string& v) {
+        if (!snapshot.insert(v).second) {
+            return;
+        }
+        const Recurrence& rec = recs.at(v);
+        for (const Affine* a : {&rec.step, &rec.inc0, &rec.inc1, &rec.expr}) {
+            for (const auto& [atom, coef] : a->terms) {
+                if (vars.count(atom)) {
+                    need(atom);
+                }
+            }
+        }
+    };
+    need(iv);
+    for (const auto& v : removable) {
+        need(v);
+    }
+
+    std::vector<std::unique_ptr<IRValue>> pre_code;
+    Emitter pre_em{pre_code, [this]() { return generate_temp_name(); }};
+    std::map<std::string, Operand> init_values;
+    for (const auto& v : snapshot) {
+        init_values[v] = pre_em.load(v);
+    }
+    auto& pre_insts = bbs[pre]->insts;
+    pre_insts.insert(pre_insts.end() - 1, std::make_move_iterator(pre_code.begin()),
+                     std::make_move_iterator(pre_code.end()));
+
+    std::vector<std::unique_ptr<IRValue>> exit_code;
+    Emitter exit_em{exit_code, [this]() { return generate_temp_name(); }};
+    emit_closed_forms(exit_em, [&](const std::string& v) { return init_values.at(v); }, removable);
+    auto& exit_insts = bbs[exit]->insts;
+    exit_insts.insert(exit_insts.begin(), std::make_move_iterator(exit_code.begin()),
+                      std::make_move_iterator(exit_code.end()));
+
+    // 删除循环中对这些变量的更新，以及因此不再被使用的计算
+    std::unordered_set<std::string> removed(removable.begin(), removable.end());
+    for (int b : chain) {
+        auto& insts = bbs[b]->insts;
+        insts.erase(std::remove_if(insts.begin(), insts.end(), [&](const std::unique_ptr<IRValue>& inst) {
+            return inst->v_tag == IRValueTag::STORE && removed.count(get_def(inst.get()));
+        }), insts.end());
+    }
+    bool erased = true;
+    while (erased) {
+        erased = false;
+        std::unordered_set<std::string> used;
+        for (const auto& bb : bbs) {
+            for (const auto& inst : bb->insts) {
+                for (auto* op : get_operands(inst.get())) {
+                    used.insert((*op)->name);
+                }
+            }
+        }
+        for (int b : chain) {
+            auto& insts = bbs[b]->insts;
+            auto it = std::remove_if(insts.begin(), insts.end(), [&](const std::unique_ptr<IRValue>& inst) {
+                return (inst->v_tag == IRValueTag::LOAD || inst->v_tag == IRValueTag::BINARY) &&
+                       !used.count(inst->name);
+            });
+            if (it != insts.end()) {
+                insts.erase(it, insts.end());
+                erased = true;
+            }
+        }
+    }
+    return true;
+}
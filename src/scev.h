@@ -0,0 +1,32 @@
+#ifndef SCEV_H
+#define SCEV_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+
+// 标量演化优化器
+// 把 while 循环中的循环携带变量识别为加法递推（add-recurrence）：
+//   一阶 {v0, +, c}、二阶 {v0, +, c0, +, c1} 以及每轮由递推重新算出的派生值，
+// 结合循环次数求出它们的出口值（闭式表达式）：
+//   1. 循环中所有变量都是递推时，直接用闭式计算替换整个循环；
+//   2. 否则把只服务于自身更新的递推变量移出循环，在出口处用闭式赋值。
+class ScalarEvolutionOptimizer {
+public:
+    ScalarEvolutionOptimizer() = default;
+
+    void optimize(Program* program);
+
+private:
+    void optimize_function(Function* func);
+
+    // 尝试变换一个循环，成功返回 true（此时 CFG 已改变）
+    bool transform_loop(Function* func, const CFG& cfg, const Loop& loop);
+
+    // 生成新的临时变量名
+    std::string generate_temp_name();
+
+    static int temp_counter;
+};
+
+#endif // SCEV_H
@@ -0,0 +1,291 @@
+#include "simplifycfg.h"
+
+namespace {
+
+// 把终结指令中跳到 from 的目标改为 to，返回是否有修改
+bool retarget(IRValue* term, const std::string& from, const std::string& to) {
+    bool changed = false;
+    if (term->v_tag == IRValueTag::JUMP) {
+        auto* jump = static_cast<JumpValue*>(term);
+        if (jump->target_block == from) {
+            jump->target_block = to;
+            changed = true;
+        }
+    } else if (term->v_tag == IRValueTag::BRANCH) {
+        auto* br = static_cast<BranchValue*>(term);
+        if (br->true_block == from) {
+            br->true_block = to;
+            changed = true;
+        }
+        if (br->false_block == from) {
+            br->false_block = to;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+} // namespace
+
+void CFGSimplifyOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+void CFGSimplifyOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+    remove_unreachable_blocks(func);
+
+    temps.clear();
+    for (const auto& bb : func->bbs) {
+        for (const auto& inst : bb->insts) {
+            if (inst->v_tag != IRValueTag::ALLOC && inst->v_tag != IRValueTag::STORE && !inst->name.empty()) {
+                temps.insert(inst->name);
+            }
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = fold_branches(func);
+        changed |= bypass_empty_blocks(func);
+        changed |= merge_blocks(func);
+        changed |= thread_jumps(func);
+        remove_unreachable_blocks(func);
+    }
+}
+
+bool CFGSimplifyOptimizer::fold_branches(Function* func) {
+    bool changed = false;
+    for (auto& bb : func->bbs) {
+        auto& term = bb->insts.back();
+        if (term->v_tag != IRValueTag::BRANCH) {
+            continue;
+        }
+        auto* br = static_cast<BranchValue*>(term.get());
+        std::string target;
+        if (br->true_block == br->false_block) {
+            target = br->true_block;
+        } else if (br->cond->v_tag == IRValueTag::INTEGER) {
+            target = static_cast<IntergerValue*>(br->cond.get())->value ? br->true_block : br->false_block;
+        } else {
+            continue;
+        }
+        term = std::make_unique<JumpValue>(target);
+        changed = true;
+    }
+    return changed;
+}
+
+bool CFGSimplifyOptimizer::bypass_empty_blocks(Function* func) {
+    auto& bbs = func->bbs;
+    bool changed = false;
+    // entry 不能绕过
+    for (size_t b = 1; b < bbs.size(); b++) {
+        const auto& insts = bbs[b]->insts;
+        if (insts.size() != 1 || insts[0]->v_tag != IRValueTag::JUMP) {
+            continue;
+        }
+        std::string target = static_cast<JumpValue*>(insts[0].get())->target_block;
+        if (target == bbs[b]->name) {
+            continue;
+        }
+        for (auto& pred : bbs) {
+            changed |= retarget(pred->insts.back().get(), bbs[b]->name, target);
+        }
+    }
+    return changed;
+}
+
+bool CFGSimplifyOptimizer::merge_blocks(Function* func) {
+    auto& bbs = func->bbs;
+    bool changed = false;
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        CFG cfg = build_cfg(func);
+        for (size_t a = 0; a < bbs.size(); a++) {
+            auto* term = bbs[a]->insts.back().get();
+            if (term->v_tag != IRValueTag::JUMP) {
+                continue;
+            }
+            int b = cfg.index.at(static_cast<JumpValue*>(term)->target_block);
+            if (b == 0 || b == static_cast<int>(a) || cfg.preds[b].size() != 1) {
+                continue;
+            }
+            auto& insts = bbs[a]->insts;
+            insts.pop_back();
+            for (auto& inst : bbs[b]->insts) {
+                insts.push_back(std::move(inst));
+            }
+            bbs.erase(bbs.begin() + b);
+            merged = changed = true;
+            break;
+        }
+    }
+    return changed;
+}
+
+CFGSimplifyOptimizer::CondKey CFGSimplifyOptimizer::cond_key(const BasicBlock* bb, const IRValue* cond) const {
+    const auto& insts = bb->insts;
+    int n = insts.size();
+
+    // 在 pos 之后（不含）变量 var 是否可能被改写
+    auto clobbered_after = [&](const std::string& var, int pos) {
+        for (int i = pos + 1; i < n; i++) {
+            if (insts[i]->v_tag == IRValueTag::CALL ||
+                (insts[i]->v_tag == IRValueTag::STORE && get_def(insts[i].get()) == var)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // 在 pos 处读取的操作数的键：常量、临时变量，或本块中 load 之后未被改写的变量
+    auto leaf = [&](const IRValue* v, int pos) -> std::string {
+        if (v->v_tag == IRValueTag::INTEGER) {
+            return v->name;
+        }
+        if (!temps.count(v->name)) {
+            return clobbered_after(v->name, pos) ? "" : v->name;
+        }
+        for (int i = pos - 1; i >= 0; i--) {
+            if (insts[i]->name != v->name) {
+                continue;
+            }
+            if (insts[i]->v_tag == IRValueTag::LOAD) {
+                const IRValue* src = static_cast<LoadValue*>(insts[i].get())->src.get();
+                if (src->v_tag == IRValueTag::INTEGER) {
+                    return src->name;
+                }
+                if (!temps.count(src->name) && !clobbered_after(src->name, i)) {
+                    return src->name;
+                }
+            }
+            break;
+        }
+        return v->name;
+    };
+
+    CondKey key;
+    for (int i = n - 1; i >= 0; i--) {
+        if (insts[i]->name != cond->name || insts[i]->v_tag == IRValueTag::STORE) {
+            continue;
+        }
+        if (insts[i]->v_tag == IRValueTag::BINARY) {
+            auto* bin = static_cast<BinaryValue*>(insts[i].get());
+            key.op = static_cast<int>(bin->op);
+            key.lhs = leaf(bin->lhs.get(), i);
+            key.rhs = leaf(bin->rhs.get(), i);
+            if (key.rhs.empty()) {
+                key.lhs.clear();
+            }
+            return key;
+        }
+        break;
+    }
+    key.lhs = leaf(cond, n - 1);
+    return key;
+}
+
+bool CFGSimplifyOptimizer::thread_jumps(Function* func) {
+    auto& bbs = func->bbs;
+    int n = bbs.size();
+    CFG cfg = build_cfg(func);
+    auto idom = compute_idom(cfg);
+
+    // 每个名字在哪些块中被读取
+    std::unordered_map<std::string, std::unordered_set<int>> used_in;
+    for (int b = 0; b < n; b++) {
+        for (const auto& inst : bbs[b]->insts) {
+            for (auto* op : get_operands(inst.get())) {
+                used_in[(*op)->name].insert(b);
+            }
+        }
+    }
+
+    // 块 x 是否只计算自己的分支条件：除末尾的 br 外都是结果只在本块使用的二元运算或 load，
+    // 且不是循环头（跳过循环头会产生不可归约的循环）
+    auto is_thin = [&](int x) {
+        const auto& insts = bbs[x]->insts;
+        if (x == 0 || insts.back()->v_tag != IRValueTag::BRANCH) {
+            return false;
+        }
+        for (size_t i = 0; i + 1 < insts.size(); i++) {
+            if (insts[i]->v_tag != IRValueTag::BINARY && insts[i]->v_tag != IRValueTag::LOAD) {
+                return false;
+            }
+            for (int user : used_in[insts[i]->name]) {
+                if (user != x) {
+                    return false;
+                }
+            }
+        }
+        for (int p : cfg.preds[x]) {
+            if (dominates(idom, x, p)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto same = [](const CondKey& a, const CondKey& b) {
+        if (a.lhs.empty() || b.lhs.empty()) {
+            return false;
+        }
+        if (a.op == b.op && a.lhs == b.lhs && a.rhs == b.rhs) {
+            return true;
+        }
+        if (a.op < 0 || b.op < 0 || a.lhs != b.rhs || a.rhs != b.lhs) {
+            return false;
+        }
+        auto op = static_cast<BinaryOp>(a.op);
+        if (is_commutative(op)) {
+            return a.op == b.op;
+        }
+        return is_compare(op) && static_cast<int>(swap_compare(op)) == b.op;
+    };
+
+    for (int p = 0; p < n; p++) {
+        auto* term = bbs[p]->insts.back().get();
+        if (term->v_tag != IRValueTag::BRANCH) {
+            continue;
+        }
+        auto* br = static_cast<BranchValue*>(term);
+        if (br->true_block == br->false_block) {
+            continue;
+        }
+        CondKey c = cond_key(bbs[p].get(), br->cond.get());
+        CondKey not_c = c;
+        if (c.op >= 0 && is_compare(static_cast<BinaryOp>(c.op))) {
+            not_c.op = static_cast<int>(negate_compare(static_cast<BinaryOp>(c.op)));
+        } else {
+            not_c.lhs.clear();
+        }
+
+        for (bool edge_true : {true, false}) {
+            int x = cfg.index.at(edge_true ? br->true_block : br->false_block);
+            if (x == p || !is_thin(x)) {
+                continue;
+            }
+            auto* xbr = static_cast<BranchValue*>(bbs[x]->insts.back().get());
+            CondKey d = cond_key(bbs[x].get(), xbr->cond.get());
+            bool outcome;
+            if (same(c, d)) {
+                outcome = edge_true;
+            } else if (same(not_c, d)) {
+                outcome = !edge_true;
+            } else {
+                continue;
+            }
+            std::string target = outcome ? xbr->true_block : xbr->false_block;
+            if (target == bbs[x]->name) {
+                continue;
+            }
+            (edge_true ? br->true_block : br->false_block) = target;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,47 @@
+#ifndef SIMPLIFYCFG_H
+#define SIMPLIFYCFG_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+// 控制流图化简，反复应用以下变换直到不再变化：
+// 1. 常量条件或两个目标相同的 br 变为 jump；
+// 2. 只有一条 jump 的块被绕过，前驱直接跳到其目标；
+// 3. 以 jump 结尾的块与其唯一后继合并（后继只有这一个前驱）；
+// 4. 跳转线程化：前驱 P 以条件 c 分支到块 X，X 只计算自己的条件 d 并分支，
+//    若在 P -> X 这条边上 d 与 c（或其否定）相同，则 P 直接跳到 X 的对应目标。
+// 块越少，输出中的 j 越少，后面的分析也越快。
+class CFGSimplifyOptimizer {
+public:
+    CFGSimplifyOptimizer() = default;
+
+    void optimize(Program* program);
+
+private:
+    void optimize_function(Function* func);
+
+    // 各变换，返回是否有修改
+    bool fold_branches(Function* func);
+    bool bypass_empty_blocks(Function* func);
+    bool merge_blocks(Function* func);
+    bool thread_jumps(Function* func);
+
+    // 条件的规范表示：op 与两个操作数的键；不是二元运算时 op 为 -1，lhs 为其名字；
+    // 无法确定时 lhs 为空
+    struct CondKey {
+        int op = -1;
+        std::string lhs;
+        std::string rhs;
+    };
+
+    // 块 bb 末尾的分支条件 cond 的键，条件中读取的变量不能在读取之后被改写
+    CondKey cond_key(const BasicBlock* bb, const IRValue* cond) const;
+
+    // 由 alloc 以外的指令定义的名字（临时变量），其余的名字都是可能被 store 改变的变量
+    std::unordered_set<std::string> temps;
+};
+
+#endif // SIMPLIFYCFG_H
@@ -0,0 +1,210 @@
+#include "sink.h"
+#include <algorithm>
+
+void CodeSinkingOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+const std::set<std::string>& CodeSinkingOptimizer::stored_between(const Function* func, const CFG& cfg,
+                                                                 int from, int to) {
+    auto key = std::make_pair(from, to);
+    auto cached = stored_cache.find(key);
+    if (cached != stored_cache.end()) {
+        return cached->second;
+    }
+
+    // 从 from 的后继出发可达、且能到达 to 的前驱的块；
+    // 经过 from 的路径会重新执行被下沉的指令，只需考虑最后一次经过 from 之后的部分
+    int n = cfg.succs.size();
+    auto reach = [&](int start, const std::vector<std::vector<int>>& next) {
+        std::vector<bool> seen(n, false);
+        std::vector<int> stack(next[start].begin(), next[start].end());
+        while (!stack.empty()) {
+            int b = stack.back();
+            stack.pop_back();
+            if (seen[b] || b == from) {
+                continue;
+            }
+            seen[b] = true;
+            stack.insert(stack.end(), next[b].begin(), next[b].end());
+        }
+        return seen;
+    };
+    auto forward = reach(from, cfg.succs);
+    auto backward = reach(to, cfg.preds);
+
+    std::set<std::string> stored;
+    for (int b = 0; b < n; b++) {
+        if (!forward[b] || !backward[b]) {
+            continue;
+        }
+        for (const auto& inst : func->bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::STORE) {
+                stored.insert(get_def(inst.get()));
+            }
+        }
+    }
+    return stored_cache[key] = std::move(stored);
+}
+
+void CodeSinkingOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+    remove_unreachable_blocks(func);
+    stored_cache.clear();
+
+    auto& bbs = func->bbs;
+    int n = bbs.size();
+    CFG cfg = build_cfg(func);
+    auto idom = compute_idom(cfg);
+
+    // 每个块所在的循环
+    auto loops = find_loops(cfg, idom);
+    std::vector<std::set<int>> loops_of(n);
+    for (size_t l = 0; l < loops.size(); l++) {
+        for (int b : loops[l].blocks) {
+            loops_of[b].insert(l);
+        }
+    }
+
+    std::set<std::string> variables;
+    std::set<std::string> params;
+    for (const auto& param : func->params) {
+        params.insert(param->name);
+    }
+    std::unordered_map<std::string, int> def_count;
+    std::unordered_map<std::string, std::vector<int>> use_blocks;
+    for (int b = 0; b < n; b++) {
+        for (const auto& inst : bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::ALLOC) {
+                variables.insert(inst->name);
+            } else if (!get_def(inst.get()).empty()) {
+                def_count[get_def(inst.get())]++;
+            }
+            for (auto* op : get_operands(inst.get())) {
+                use_blocks[(*op)->name].push_back(b);
+            }
+        }
+    }
+
+    auto depth = [&](int b) {
+        int d = 0;
+        for (int x = b; x != 0; x = idom[x]) {
+            d++;
+        }
+        return d;
+    };
+    auto common_dominator = [&](int a, int b) {
+        int da = depth(a), db = depth(b);
+        for (; da > db; da--) a = idom[a];
+        for (; db > da; db--) b = idom[b];
+        while (a != b) {
+            a = idom[a];
+            b = idom[b];
+        }
+        return a;
+    };
+
+    // 先处理支配树中较深的块：使用者下沉后，定义它的值再跟着下沉
+    std::vector<int> order(n);
+    std::vector<int> block_depth(n);
+    for (int b = 0; b < n; b++) {
+        order[b] = b;
+        block_depth[b] = depth(b);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return block_depth[a] > block_depth[b]; });
+
+    // 下沉到块首的指令，按原顺序排列
+    std::vector<std::vector<std::unique_ptr<IRValue>>> sunk(n);
+    for (int b : order) {
+        auto& insts = bbs[b]->insts;
+        // 从后往前处理，使用者先下沉，被使用的值随后跟到同一个块
+        for (int i = static_cast<int>(insts.size()) - 1; i >= 0; i--) {
+            IRValue* inst = insts[i].get();
+            // 二元运算和 load 看其结果的使用，store 看所写变量的读取
+            std::string value;
+            if (inst->v_tag == IRValueTag::BINARY || inst->v_tag == IRValueTag::LOAD) {
+                if (variables.count(inst->name) || def_count[inst->name] != 1) {
+                    continue;
+                }
+                value = inst->name;
+            } else if (inst->v_tag == IRValueTag::STORE) {
+                const auto* store = static_cast<const StoreValue*>(inst);
+                if (!variables.count(get_def(inst)) || params.count(store->value->name)) {
+                    continue;
+                }
+                value = get_def(inst);
+            } else {
+                continue;
+            }
+            auto uses = use_blocks.find(value);
+            if (uses == use_blocks.end() || uses->second.empty()) {
+                continue; // 死代码留给 DCE
+            }
+            int lca = uses->second[0];
+            for (int u : uses->second) {
+                lca = common_dominator(lca, u);
+            }
+            if (lca == b || !dominates(idom, b, lca)) {
+                continue;
+            }
+
+            // 从 lca 向上到 b，取不在 b 之外循环中、循环层数最少、最靠近使用的块
+            int target = b;
+            for (int x = lca; x != b; x = idom[x]) {
+                bool inside = std::includes(loops_of[b].begin(), loops_of[b].end(),
+                                            loops_of[x].begin(), loops_of[x].end());
+                if (inside && (target == b || loops_of[x].size() < loops_of[target].size())) {
+                    target = x;
+                }
+            }
+            if (target == b) {
+                continue;
+            }
+
+            // 读取的变量在途中不能被改写；下沉 store 时，所写变量在途中也不能被改写，
+            // 且它的所有读取都在目标块支配的范围内，不经过目标块的路径上不会读到它
+            auto unchanged = [&](const std::string& var) {
+                for (size_t k = i + 1; k < insts.size(); k++) {
+                    if (insts[k]->v_tag == IRValueTag::STORE && get_def(insts[k].get()) == var) {
+                        return false;
+                    }
+                }
+                return !stored_between(func, cfg, b, target).count(var);
+            };
+            bool safe = true;
+            for (auto* op : get_operands(inst)) {
+                if (variables.count((*op)->name)) {
+                    safe = safe && unchanged((*op)->name);
+                }
+            }
+            if (inst->v_tag == IRValueTag::STORE) {
+                safe = safe && unchanged(value);
+                for (int u : uses->second) {
+                    safe = safe && u != b && dominates(idom, target, u);
+                }
+            }
+            if (!safe) {
+                continue;
+            }
+
+            // 使用记录随指令一起移动
+            for (auto* op : get_operands(inst)) {
+                auto& blocks = use_blocks[(*op)->name];
+                auto it = std::find(blocks.begin(), blocks.end(), b);
+                if (it != blocks.end()) {
+                    *it = target;
+                }
+            }
+            sunk[target].insert(sunk[target].begin(), std::move(insts[i]));
+            insts.erase(insts.begin() + i);
+        }
+    }
+
+    for (int b = 0; b < n; b++) {
+        auto& insts = bbs[b]->insts;
+        insts.insert(insts.begin(), std::make_move_iterator(sunk[b].begin()),
+                     std::make_move_iterator(sunk[b].end()));
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef SINK_H
+#define SINK_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 代码下沉：把没有副作用的指令（二元运算、load）移到支配其所有使用的、执行次数最少的块中。
+// 对局部变量的 store 也可以下沉，此时“使用”为该变量的读取（如只在 then 分支中读取的变量）。
+// 候选块在支配树上从所有使用的最近公共支配者向上找到定义所在的块，
+// 取所在循环最少（不进入定义处没有的循环）且最靠近使用的那个；
+// 这样只在需要该值的路径上计算它，分支两侧的寄存器压力也随之降低。
+// 读取变量的指令只有在定义处到目标块的所有路径上都不改写该变量时才下沉。
+class CodeSinkingOptimizer {
+public:
+    CodeSinkingOptimizer() = default;
+
+    void optimize(Program* program);
+
+private:
+    void optimize_function(Function* func);
+
+    // 从块 from 到块 to 入口的路径上（不含 from 中指令之前的部分）可能被 store 的变量
+    const std::set<std::string>& stored_between(const Function* func, const CFG& cfg, int from, int to);
+
+    std::map<std::pair<int, int>, std::set<std::string>> stored_cache;
+};
+
+#endif // SINK_H
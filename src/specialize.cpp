@@ -0,0 +1,240 @@
+#include "specialize.h"
+#include "consprop.h"
+#include "instcombine.h"
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+int FunctionSpecializationOptimizer::temp_counter = 0;
+
+FunctionSpecializationOptimizer::FunctionSpecializationOptimizer(int clone_budget, int max_clones)
+    : clone_budget(clone_budget), max_clones(max_clones) {}
+
+std::string FunctionSpecializationOptimizer::generate_function_name(const Function* func) {
+    std::ostringstream oss;
+    oss << func->name << "_spec_" << temp_counter++;
+    return oss.str();
+}
+
+std::string FunctionSpecializationOptimizer::get_pattern(const CallValue* call) const {
+    std::ostringstream oss;
+    bool has_const = false;
+    oss << call->callee << "(";
+    for (size_t i = 0; i < call->args.size(); i++) {
+        if (i > 0) {
+            oss << ",";
+        }
+        if (call->args[i]->v_tag == IRValueTag::INTEGER) {
+            oss << static_cast<const IntergerValue*>(call->args[i].get())->value;
+            has_const = true;
+        } else {
+            oss << "_";
+        }
+    }
+    oss << ")";
+    return has_const ? oss.str() : "";
+}
+
+int FunctionSpecializationOptimizer::estimate_benefit(const CallValue* call, const Function* callee) const {
+    std::unordered_set<std::string> const_params;
+    for (size_t i = 0; i < call->args.size(); i++) {
+        if (call->args[i]->v_tag == IRValueTag::INTEGER) {
+            const_params.insert(callee->params[i]->name);
+        }
+    }
+
+    // 参数在 entry 中的局部副本
+    std::unordered_set<std::string> const_copies;
+    for (const auto& inst : callee->bbs[0]->insts) {
+        auto* store = dynamic_cast<const StoreValue*>(inst.get());
+        if (store && const_params.count(store->value->name)) {
+            const_copies.insert(store->dest->name);
+        }
+    }
+
+    int benefit = 0;
+    for (const auto& bb : callee->bbs) {
+        for (const auto& inst : bb->insts) {
+            for (auto* op : get_operands(inst.get())) {
+                if (const_copies.count((*op)->name)) {
+                    benefit++;
+                }
+            }
+        }
+    }
+    return benefit;
+}
+
+std::unique_ptr<Function> FunctionSpecializationOptimizer::clone_function(const Function* callee,
+                                                                          const CallValue* call) {
+    std::string name = generate_function_name(callee);
+
+    // 常量参数 -> 常量值，其余参数按顺序重新编号
+    std::unordered_map<std::string, int> const_params;
+    std::vector<std::unique_ptr<IRType>> param_types;
+    std::vector<std::unique_ptr<FuncArgRefValue>> params;
+    for (size_t i = 0; i < callee->params.size(); i++) {
+        const auto& arg = call->args[i];
+        if (arg->v_tag == IRValueTag::INTEGER) {
+            const_params[callee->params[i]->name] = static_cast<const IntergerValue*>(arg.get())->value;
+        } else {
+            param_types.push_back(std::make_unique<Int32Type>());
+            params.push_back(std::make_unique<FuncArgRefValue>(params.size(), callee->params[i]->name));
+        }
+    }
+    std::unique_ptr<IRType> ret_type;
+    if (callee->f_type->return_type->isUnit()) {
+        ret_type = std::make_unique<UnitType>();
+    } else {
+        ret_type = std::make_unique<Int32Type>();
+    }
+    auto func = std::make_unique<Function>(name, std::make_unique<FunctionType>(std::move(param_types),
+                                                                                std::move(ret_type)));
+    func->local_var_count = callee->local_var_count;
+    for (auto& param : params) {
+        func->add_param(std::move(param));
+    }
+
+    // 块名在汇编中是全局标号，加上新函数名作为前缀
+    std::unordered_map<std::string, std::string> blocks;
+    for (const auto& bb : callee->bbs) {
+        blocks[bb->name] = bb == callee->bbs[0] ? bb->name : "%" + name.substr(1) + "_" + bb->name.substr(1);
+    }
+
+    for (const auto& bb : callee->bbs) {
+        auto new_bb = std::make_unique<BasicBlock>(blocks[bb->name]);
+        for (const auto& inst : bb->insts) {
+            auto new_inst = clone_inst(inst.get());
+            for (auto* op : get_operands(new_inst.get())) {
+                auto it = const_params.find((*op)->name);
+                if (it != const_params.end()) {
+                    *op = std::make_unique<IntergerValue>(it->second);
+                }
+            }
+            if (auto* br = dynamic_cast<BranchValue*>(new_inst.get())) {
+                br->true_block = blocks[br->true_block];
+                br->false_block = blocks[br->false_block];
+            } else if (auto* jump = dynamic_cast<JumpValue*>(new_inst.get())) {
+                jump->target_block = blocks[jump->target_block];
+            }
+            new_bb->add_inst(std::move(new_inst));
+        }
+        func->add_basic_block(std::move(new_bb));
+    }
+    return func;
+}
+
+void FunctionSpecializationOptimizer::redirect_call(CallValue* call, const std::string& target) {
+    std::vector<std::unique_ptr<IRValue>> args;
+    for (auto& arg : call->args) {
+        if (arg->v_tag != IRValueTag::INTEGER) {
+            args.push_back(std::move(arg));
+        }
+    }
+    call->args = std::move(args);
+    call->callee = target;
+}
+
+bool FunctionSpecializationOptimizer::redirect_calls(Program* program) {
+    bool changed = false;
+    for (auto& func : program->funcs) {
+        for (auto& bb : func->bbs) {
+            for (auto& inst : bb->insts) {
+                auto* call = dynamic_cast<CallValue*>(inst.get());
+                if (!call) {
+                    continue;
+                }
+                auto it = specialized.find(get_pattern(call));
+                if (it != specialized.end()) {
+                    redirect_call(call, it->second);
+                    changed = true;
+                }
+            }
+        }
+    }
+    return changed;
+}
+
+void FunctionSpecializationOptimizer::optimize(Program* program) {
+    ConstantPropagationOptimizer consprop;
+    InstCombineOptimizer instcombine;
+
+    int budget = clone_budget;
+    for (int round = 0; round < 4; round++) {
+        function_map.clear();
+        for (auto& func : program->funcs) {
+            function_map[func->name] = func.get();
+        }
+        redirect_calls(program);
+
+        // 按常量模式收集候选
+        auto origin_of = [&](const std::string& name) {
+            auto it = origin.find(name);
+            return it == origin.end() ? name : it->second;
+        };
+        std::unordered_map<std::string, Candidate> candidates;
+        for (auto& func : program->funcs) {
+            for (auto& bb : func->bbs) {
+                for (auto& inst : bb->insts) {
+                    auto* call = dynamic_cast<CallValue*>(inst.get());
+                    if (!call) {
+                        continue;
+                    }
+                    std::string pattern = get_pattern(call);
+                    auto it = function_map.find(call->callee);
+                    if (pattern.empty() || it == function_map.end() || it->second->name == "@main" ||
+                        it->second->params.size() != call->args.size() ||
+                        origin_of(func->name) == origin_of(call->callee)) {
+                        continue;
+                    }
+                    auto& candidate = candidates[pattern];
+                    if (!candidate.callee) {
+                        candidate.callee = it->second;
+                        candidate.benefit = estimate_benefit(call, it->second);
+                    }
+                    candidate.calls.push_back(call);
+                }
+            }
+        }
+
+        // 调用次数 * 收益 从大到小特化
+        std::vector<std::pair<std::string, Candidate*>> order;
+        for (auto& [pattern, candidate] : candidates) {
+            if (candidate.benefit > 0) {
+                order.push_back({pattern, &candidate});
+            }
+        }
+        std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+            int score_a = a.second->benefit * static_cast<int>(a.second->calls.size());
+            int score_b = b.second->benefit * static_cast<int>(b.second->calls.size());
+            return score_a != score_b ? score_a > score_b : a.first < b.first;
+        });
+
+        bool changed = false;
+        for (auto& [pattern, candidate] : order) {
+            const Function* callee = candidate->callee;
+            int size = 0;
+            for (const auto& bb : callee->bbs) {
+                size += bb->insts.size();
+            }
+            if (size > budget || clone_count[callee->name] >= max_clones) {
+                continue;
+            }
+            auto func = clone_function(callee, candidate->calls[0]);
+            specialized[pattern] = func->name;
+            origin[func->name] = origin_of(callee->name);
+            clone_count[callee->name]++;
+            budget -= size;
+            program->funcs.push_back(std::move(func));
+            changed = true;
+        }
+        if (!changed) {
+            break;
+        }
+
+        // 化简特化版本，暴露出新的常量实参
+        redirect_calls(program);
+        consprop.optimize(program);
+        instcombine.optimize(program);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef SPECIALIZE_H
+#define SPECIALIZE_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 函数特化（过程间常量传播）
+// 统计所有以常量为实参的调用点，按“实参中的常量模式”分组，例如 f(x, 8) 的模式为 f(_, 8)。
+// 对收益最大的模式复制出一个特化版本：常量参数从参数列表中删去，函数体内直接使用该常量，
+// 再对程序做常量传播和代数化简；匹配该模式的调用改为调用特化版本。
+// 特化版本中的递归调用化简后也可能匹配同一模式，因此重复若干轮；
+// 但递归调用不会产生新的特化版本，避免把递归按常量实参逐层展开。
+// 复制的总指令数受 clone_budget 限制，每个函数最多特化 max_clones 个版本。
+class FunctionSpecializationOptimizer {
+public:
+    FunctionSpecializationOptimizer(int clone_budget = 256, int max_clones = 4);
+
+    void optimize(Program* program);
+
+private:
+    // 一个常量模式的所有调用点
+    struct Candidate {
+        const Function* callee = nullptr;
+        std::vector<CallValue*> calls;
+        int benefit = 0;
+    };
+
+    int clone_budget;
+    int max_clones;
+
+    std::unordered_map<std::string, Function*> function_map;
+
+    // 常量模式 -> 特化版本的函数名
+    std::unordered_map<std::string, std::string> specialized;
+
+    // 每个函数已有的特化版本数
+    std::unordered_map<std::string, int> clone_count;
+
+    // 特化版本 -> 原函数名
+    std::unordered_map<std::string, std::string> origin;
+
+    // 调用的常量模式，如 "@f(_,8)"；没有常量实参时返回空串
+    std::string get_pattern(const CallValue* call) const;
+
+    // 常量参数的每次使用都可能被折叠，以使用次数作为特化的收益
+    int estimate_benefit(const CallValue* call, const Function* callee) const;
+
+    // 按 call 的常量模式复制 callee，返回特化版本
+    std::unique_ptr<Function> clone_function(const Function* callee, const CallValue* call);
+
+    // 把调用改为调用特化版本，删去常量实参
+    void redirect_call(CallValue* call, const std::string& target);
+
+    // 把所有匹配已有特化版本的调用重定向，返回是否有改变
+    bool redirect_calls(Program* program);
+
+    std::string generate_function_name(const Function* func);
+
+    static int temp_counter;
+};
+
+#endif // SPECIALIZE_H
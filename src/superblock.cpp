@@ -0,0 +1,289 @@
+#include "superblock.h"
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+int SuperblockOptimizer::temp_counter = 0;
+
+SuperblockOptimizer::SuperblockOptimizer(int block_size_limit, int growth_limit)
+    : block_size_limit(block_size_limit), growth_limit(growth_limit) {}
+
+std::string SuperblockOptimizer::generate_temp_name() {
+    std::ostringstream oss;
+    oss << "%superblock_" << temp_counter++;
+    return oss.str();
+}
+
+std::string SuperblockOptimizer::generate_block_name(const Function* func) {
+    std::ostringstream oss;
+    oss << "%" << func->get_func_name() << "_superblock_" << temp_counter++;
+    return oss.str();
+}
+
+void SuperblockOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+int SuperblockOptimizer::likely_successor(const Function* func, const CFG& cfg, const std::vector<Loop>& loops,
+                                          const std::vector<int>& depth, int b) const {
+    const IRValue* term = func->bbs[b]->insts.back().get();
+    if (term->v_tag == IRValueTag::JUMP) {
+        return cfg.succs[b][0];
+    }
+    if (term->v_tag != IRValueTag::BRANCH) {
+        return -1;
+    }
+    auto* br = static_cast<const BranchValue*>(term);
+    int t = cfg.index.at(br->true_block);
+    int f = cfg.index.at(br->false_block);
+    if (t == f) {
+        return t;
+    }
+
+    // 留在最内层循环中的一侧
+    for (const auto& loop : loops) {
+        if (!loop.blocks.count(b)) {
+            continue;
+        }
+        bool t_in = loop.blocks.count(t), f_in = loop.blocks.count(f);
+        if (t_in != f_in) {
+            return t_in ? t : f;
+        }
+        break;
+    }
+    // 进入更深循环的一侧
+    if (depth[t] != depth[f]) {
+        return depth[t] > depth[f] ? t : f;
+    }
+    // 不直接 return 的一侧
+    bool t_ret = func->bbs[t]->insts.back()->v_tag == IRValueTag::RETURN;
+    bool f_ret = func->bbs[f]->insts.back()->v_tag == IRValueTag::RETURN;
+    if (t_ret != f_ret) {
+        return t_ret ? f : t;
+    }
+    // 相等比较多为假
+    for (const auto& inst : func->bbs[b]->insts) {
+        if (inst->v_tag == IRValueTag::BINARY && inst->name == br->cond->name) {
+            BinaryOp op = static_cast<const BinaryValue*>(inst.get())->op;
+            if (op == BinaryOp::EQ) {
+                return f;
+            }
+            if (op == BinaryOp::NE) {
+                return t;
+            }
+        }
+    }
+    return -1;
+}
+
+BasicBlock* SuperblockOptimizer::duplicate_tail(Function* func, BasicBlock* pred, const BasicBlock* join) {
+    auto& bbs = func->bbs;
+
+    // 只在 join 中使用的临时变量在副本中改名，其余的两份定义同一个名字
+    std::unordered_set<std::string> used_outside;
+    for (const auto& bb : bbs) {
+        if (bb.get() == join) {
+            continue;
+        }
+        for (const auto& inst : bb->insts) {
+            for (auto* op : get_operands(inst.get())) {
+                used_outside.insert((*op)->name);
+            }
+        }
+    }
+    std::unordered_map<std::string, std::string> rename;
+    for (const auto& inst : join->insts) {
+        if (inst->v_tag == IRValueTag::LOAD || inst->v_tag == IRValueTag::BINARY ||
+            inst->v_tag == IRValueTag::CALL) {
+            if (!used_outside.count(inst->name) && !rename.count(inst->name)) {
+                rename[inst->name] = generate_temp_name();
+            }
+        }
+    }
+
+    auto copy = std::make_unique<BasicBlock>(generate_block_name(func));
+    for (const auto& inst : join->insts) {
+        auto c = clone_inst(inst.get());
+        for (auto* op : get_operands(c.get())) {
+            auto it = rename.find((*op)->name);
+            if ((*op)->v_tag == IRValueTag::VAR_REF && it != rename.end()) {
+                *op = std::make_unique<VarRefValue>(it->second);
+            }
+        }
+        if (c->v_tag != IRValueTag::STORE && rename.count(c->name)) {
+            c->name = rename[c->name];
+        }
+        copy->add_inst(std::move(c));
+    }
+
+    IRValue* term = pred->insts.back().get();
+    if (term->v_tag == IRValueTag::JUMP) {
+        static_cast<JumpValue*>(term)->target_block = copy->name;
+    } else if (term->v_tag == IRValueTag::BRANCH) {
+        auto* br = static_cast<BranchValue*>(term);
+        if (br->true_block == join->name) br->true_block = copy->name;
+        if (br->false_block == join->name) br->false_block = copy->name;
+    }
+
+    BasicBlock* result = copy.get();
+    auto pos = std::find_if(bbs.begin(), bbs.end(), [&](const std::unique_ptr<BasicBlock>& bb) {
+        return bb.get() == pred;
+    });
+    bbs.insert(pos + 1, std::move(copy));
+    return result;
+}
+
+void SuperblockOptimizer::value_number(const CFG& cfg, const std::vector<BasicBlock*>& trace) {
+    // 可用的运算：lhs op rhs 已存于 result
+    struct Available {
+        BinaryOp op;
+        std::string lhs, rhs, result;
+    };
+    std::vector<Available> table;
+    // 复制（包括被替换成复制的运算）的结果 -> 源，比较操作数时用源代替
+    std::unordered_map<std::string, std::string> copy_of;
+    auto leader = [&](const std::string& name) {
+        auto it = copy_of.find(name);
+        return it == copy_of.end() ? name : it->second;
+    };
+
+    for (BasicBlock* bb : trace) {
+        // 之后的复制可能给路径中的块增加了其它前驱，此时前面的结果不再可用
+        if (cfg.preds[cfg.index.at(bb->name)].size() != 1) {
+            table.clear();
+            copy_of.clear();
+        }
+        for (auto& inst : bb->insts) {
+            Available cur{BinaryOp::ADD, "", "", ""};
+            std::string source;
+            if (inst->v_tag == IRValueTag::BINARY) {
+                auto* bin = static_cast<BinaryValue*>(inst.get());
+                cur = {bin->op, leader(bin->lhs->name), leader(bin->rhs->name), inst->name};
+                if (is_commutative(cur.op) && cur.lhs > cur.rhs) {
+                    std::swap(cur.lhs, cur.rhs);
+                }
+                auto it = std::find_if(table.begin(), table.end(), [&](const Available& a) {
+                    return a.op == cur.op && a.lhs == cur.lhs && a.rhs == cur.rhs;
+                });
+                if (it != table.end() && it->result != inst->name) {
+                    inst = std::make_unique<LoadValue>(inst->name, std::make_unique<VarRefValue>(it->result));
+                    source = it->result;
+                    cur.result.clear();
+                }
+            } else if (inst->v_tag == IRValueTag::LOAD) {
+                source = leader(static_cast<LoadValue*>(inst.get())->src->name);
+            }
+
+            // 重新定义的名字使用到它的运算和复制都不再可用
+            std::string def = get_def(inst.get());
+            if (!def.empty()) {
+                table.erase(std::remove_if(table.begin(), table.end(), [&](const Available& a) {
+                    return a.lhs == def || a.rhs == def || a.result == def;
+                }), table.end());
+                for (auto it = copy_of.begin(); it != copy_of.end();) {
+                    it = it->first == def || it->second == def ? copy_of.erase(it) : std::next(it);
+                }
+            }
+            if (!cur.result.empty() && cur.lhs != cur.result && cur.rhs != cur.result) {
+                table.push_back(cur);
+            }
+            if (!source.empty() && source != inst->name) {
+                copy_of[inst->name] = source;
+            }
+        }
+    }
+}
+
+void SuperblockOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+    remove_unreachable_blocks(func);
+
+    auto& bbs = func->bbs;
+    int n = bbs.size();
+    CFG cfg = build_cfg(func);
+    auto idom = compute_idom(cfg);
+    auto loops = find_loops(cfg, idom);
+    std::vector<int> depth(n, 0);
+    std::unordered_set<const BasicBlock*> headers;
+    for (const auto& loop : loops) {
+        headers.insert(bbs[loop.header].get());
+        for (int b : loop.blocks) {
+            depth[b] = std::max(depth[b], loop.depth);
+        }
+    }
+
+    // 以下按块指针操作，复制会改变下标；副本沿用原块的预测和深度
+    std::unordered_map<const BasicBlock*, BasicBlock*> likely;
+    std::unordered_map<const BasicBlock*, int> block_depth;
+    for (int b = 0; b < n; b++) {
+        int s = likely_successor(func, cfg, loops, depth, b);
+        likely[bbs[b].get()] = s < 0 ? nullptr : bbs[s].get();
+        block_depth[bbs[b].get()] = depth[b];
+    }
+    auto pred_count = [&](const BasicBlock* target) {
+        int count = 0;
+        for (const auto& bb : bbs) {
+            const IRValue* term = bb->insts.back().get();
+            if (term->v_tag == IRValueTag::JUMP) {
+                count += static_cast<const JumpValue*>(term)->target_block == target->name;
+            } else if (term->v_tag == IRValueTag::BRANCH) {
+                auto* br = static_cast<const BranchValue*>(term);
+                count += br->true_block == target->name || br->false_block == target->name;
+            }
+        }
+        return count;
+    };
+
+    // 从最深的循环开始选择路径的起点
+    std::vector<BasicBlock*> seeds;
+    for (const auto& bb : bbs) {
+        seeds.push_back(bb.get());
+    }
+    std::stable_sort(seeds.begin(), seeds.end(), [&](const BasicBlock* a, const BasicBlock* b) {
+        return block_depth[a] > block_depth[b];
+    });
+
+    int budget = growth_limit;
+    std::unordered_set<const BasicBlock*> in_trace;
+    std::vector<std::vector<BasicBlock*>> traces;
+    for (BasicBlock* seed : seeds) {
+        if (in_trace.count(seed)) {
+            continue;
+        }
+        std::vector<BasicBlock*> trace = {seed};
+        in_trace.insert(seed);
+        for (BasicBlock* cur = seed;;) {
+            BasicBlock* next = likely[cur];
+            if (!next || in_trace.count(next) || headers.count(next) || next == bbs[0].get() ||
+                block_depth[next] != block_depth[seed]) {
+                break;
+            }
+            if (pred_count(next) > 1) {
+                int size = next->insts.size();
+                bool has_alloc = std::any_of(next->insts.begin(), next->insts.end(),
+                                             [](const std::unique_ptr<IRValue>& inst) {
+                                                 return inst->v_tag == IRValueTag::ALLOC;
+                                             });
+                if (size > block_size_limit || size > budget || has_alloc) {
+                    break;
+                }
+                BasicBlock* copy = duplicate_tail(func, cur, next);
+                budget -= size;
+                likely[copy] = likely[next];
+                block_depth[copy] = block_depth[next];
+                next = copy;
+            }
+            trace.push_back(next);
+            in_trace.insert(next);
+            cur = next;
+        }
+        traces.push_back(std::move(trace));
+    }
+
+    cfg = build_cfg(func);
+    for (const auto& trace : traces) {
+        value_number(cfg, trace);
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef SUPERBLOCK_H
+#define SUPERBLOCK_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 超级块（superblock）形成
+// 没有 profile 数据，按静态启发式预测分支方向：留在循环内的一侧、进入更深循环的一侧更可能，
+// 直接 return 的一侧不太可能，eq 比较多为假、ne 比较多为真。
+// 从循环最深的块出发，沿最可能的后继延伸出热路径（trace），不越过循环头、不离开当前循环。
+// 路径上有多个前驱的汇合块（如 if_end_N）复制一份给路径上的前驱（tail duplication），
+// 使路径只有开头一个入口，其余的边都是侧出口；之后 simplifycfg 把以 jump 相连的部分合并成直线代码。
+// 沿每条路径做局部值编号：前面的块中已经计算过、操作数未被改写的运算变为复制。
+// 复制会使代码膨胀，因此限制被复制块的大小和每个函数的总增长量。
+class SuperblockOptimizer {
+public:
+    SuperblockOptimizer(int block_size_limit = 16, int growth_limit = 128);
+
+    void optimize(Program* program);
+
+private:
+    // 可复制的汇合块的最大指令数
+    int block_size_limit;
+
+    // 每个函数因复制而增加的最大指令数
+    int growth_limit;
+
+    void optimize_function(Function* func);
+
+    // 块 b 最可能的后继，以 ret 结尾或无法预测时返回 -1
+    int likely_successor(const Function* func, const CFG& cfg, const std::vector<Loop>& loops,
+                         const std::vector<int>& depth, int b) const;
+
+    // 复制汇合块 join 给前驱 pred，副本放在 pred 之后，返回副本
+    BasicBlock* duplicate_tail(Function* func, BasicBlock* pred, const BasicBlock* join);
+
+    // 沿一条路径做局部值编号，只有一个前驱的块继承前一个块末尾可用的运算
+    void value_number(const CFG& cfg, const std::vector<BasicBlock*>& trace);
+
+    // 生成新的临时变量名 / 基本块名
+    std::string generate_temp_name();
+    std::string generate_block_name(const Function* func);
+
+    static int temp_counter;
+};
+
+#endif // SUPERBLOCK_H
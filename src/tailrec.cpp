@@ -0,0 +1,203 @@
+#include "tailrec.h"
+#include <sstream>
+
+int TailRecursionOptimizer::temp_counter = 0;
+
+std::string TailRecursionOptimizer::generate_temp_name() {
+    std::ostringstream oss;
+    oss << "%tailrec_" << temp_counter++;
+    return oss.str();
+}
+
+std::string TailRecursionOptimizer::generate_block_name(const Function* func) {
+    std::ostringstream oss;
+    oss << "%" << func->get_func_name() << "_tailrec_" << temp_counter++;
+    return oss.str();
+}
+
+void TailRecursionOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+bool TailRecursionOptimizer::get_tail_site(const Function* func, BasicBlock* bb, TailSite& site) {
+    size_t n = bb->insts.size();
+    auto* ret = n > 0 ? dynamic_cast<ReturnValue*>(bb->insts.back().get()) : nullptr;
+    if (!ret || n < 2) {
+        return false;
+    }
+
+    // call; ret
+    auto* call = dynamic_cast<CallValue*>(bb->insts[n - 2].get());
+    if (call && call->callee == func->name &&
+        (ret->value == nullptr || (!call->name.empty() && ret->value->name == call->name))) {
+        site.call = call;
+        site.accumulate = nullptr;
+        return true;
+    }
+
+    // call; op; ret，op 的另一个操作数不能依赖这次调用的结果
+    auto* bin = dynamic_cast<BinaryValue*>(bb->insts[n - 2].get());
+    call = n >= 3 ? dynamic_cast<CallValue*>(bb->insts[n - 3].get()) : nullptr;
+    if (!bin || !call || call->callee != func->name || call->name.empty() || ret->value == nullptr ||
+        ret->value->name != bin->name) {
+        return false;
+    }
+    if (bin->op != BinaryOp::ADD && bin->op != BinaryOp::MUL) {
+        return false;
+    }
+    if ((bin->lhs->name == call->name) == (bin->rhs->name == call->name)) {
+        return false;
+    }
+    // 同一函数中只使用一种累加运算
+    if (!acc.empty() && bin->op != acc_op) {
+        return false;
+    }
+    site.call = call;
+    site.accumulate = bin;
+    return true;
+}
+
+std::string TailRecursionOptimizer::split_entry(Function* func) {
+    BasicBlock* entry = func->bbs[0].get();
+
+    // entry 中最后一条参数 store 之后的指令构成循环头
+    std::unordered_set<std::string> params;
+    for (const auto& param : func->params) {
+        params.insert(param->name);
+    }
+    size_t split = 0;
+    for (size_t i = 0; i < entry->insts.size(); i++) {
+        auto* store = dynamic_cast<StoreValue*>(entry->insts[i].get());
+        if (store && params.count(store->value->name)) {
+            split = i + 1;
+        }
+    }
+
+    auto header = std::make_unique<BasicBlock>(generate_block_name(func));
+    for (size_t i = split; i < entry->insts.size(); i++) {
+        header->add_inst(std::move(entry->insts[i]));
+    }
+    entry->insts.resize(split);
+
+    // 累加器初始化为单位元
+    if (!acc.empty()) {
+        entry->add_inst(std::make_unique<AllocValue>(acc));
+        entry->add_inst(std::make_unique<StoreValue>(std::make_unique<IntergerValue>(acc_op == BinaryOp::ADD ? 0 : 1),
+                                                     std::make_unique<VarRefValue>(acc)));
+    }
+    entry->add_inst(std::make_unique<JumpValue>(header->name));
+
+    std::string name = header->name;
+    func->bbs.insert(func->bbs.begin() + 1, std::move(header));
+    return name;
+}
+
+void TailRecursionOptimizer::replace_tail_call(BasicBlock* bb, const TailSite& site, const std::string& header) {
+    size_t removed = site.accumulate ? 3 : 2;
+    auto call_inst = std::move(bb->insts[bb->insts.size() - removed]);
+    auto* call = dynamic_cast<CallValue*>(call_inst.get());
+    std::unique_ptr<IRValue> acc_inst;
+    if (site.accumulate) {
+        acc_inst = std::move(bb->insts[bb->insts.size() - 2]);
+    }
+    bb->insts.resize(bb->insts.size() - removed);
+
+    // acc = acc op x，x 在调用前后的值相同（调用不会修改局部变量）
+    if (site.accumulate) {
+        auto* bin = dynamic_cast<BinaryValue*>(acc_inst.get());
+        auto& x = bin->lhs->name == call->name ? bin->rhs : bin->lhs;
+        std::string temp = generate_temp_name();
+        bb->add_inst(std::make_unique<BinaryValue>(temp, acc_op, std::make_unique<VarRefValue>(acc), std::move(x)));
+        bb->add_inst(std::make_unique<StoreValue>(std::make_unique<VarRefValue>(temp),
+                                                  std::make_unique<VarRefValue>(acc)));
+    }
+
+    // 先读出所有实参，避免前面的参数赋值影响后面的实参（如 f(b, a)）
+    std::vector<std::unique_ptr<IRValue>> values;
+    for (auto& arg : call->args) {
+        if (variables.count(arg->name)) {
+            std::string temp = generate_temp_name();
+            bb->add_inst(std::make_unique<LoadValue>(temp, std::make_unique<VarRefValue>(arg->name)));
+            values.push_back(std::make_unique<VarRefValue>(temp));
+        } else {
+            values.push_back(std::move(arg));
+        }
+    }
+
+    for (size_t i = 0; i < values.size(); i++) {
+        bb->add_inst(std::make_unique<StoreValue>(std::move(values[i]),
+                                                  std::make_unique<VarRefValue>(param_vars[i])));
+    }
+    bb->add_inst(std::make_unique<JumpValue>(header));
+}
+
+void TailRecursionOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+
+    // 找出尾调用，第一个带累加的调用决定累加运算
+    acc.clear();
+    bool found = false, accumulate = false;
+    for (auto& bb : func->bbs) {
+        TailSite site;
+        if (get_tail_site(func, bb.get(), site)) {
+            found = true;
+            if (site.accumulate && !accumulate) {
+                accumulate = true;
+                acc_op = site.accumulate->op;
+            }
+        }
+    }
+    if (!found) {
+        return;
+    }
+
+    // 每个参数都需要在 entry 中有一个局部副本，跳回后通过它读取新的参数值
+    variables.clear();
+    param_vars.assign(func->params.size(), "");
+    for (const auto& bb : func->bbs) {
+        for (const auto& inst : bb->insts) {
+            if (inst->v_tag == IRValueTag::ALLOC) {
+                variables.insert(inst->name);
+            }
+        }
+    }
+    for (const auto& inst : func->bbs[0]->insts) {
+        auto* store = dynamic_cast<StoreValue*>(inst.get());
+        if (!store) {
+            continue;
+        }
+        for (size_t i = 0; i < func->params.size(); i++) {
+            if (store->value->name == func->params[i]->name) {
+                param_vars[i] = store->dest->name;
+            }
+        }
+    }
+    for (const auto& var : param_vars) {
+        if (var.empty() || !variables.count(var)) {
+            return;
+        }
+    }
+
+    if (accumulate) {
+        acc = generate_temp_name();
+    }
+    std::string header = split_entry(func);
+    for (auto& bb : func->bbs) {
+        TailSite site;
+        if (get_tail_site(func, bb.get(), site)) {
+            replace_tail_call(bb.get(), site, header);
+        } else if (accumulate && !bb->insts.empty()) {
+            // 其余的返回点：ret v 变为 ret acc op v
+            auto* ret = dynamic_cast<ReturnValue*>(bb->insts.back().get());
+            if (ret && ret->value) {
+                std::string temp = generate_temp_name();
+                auto result = std::make_unique<BinaryValue>(temp, acc_op, std::make_unique<VarRefValue>(acc),
+                                                            std::move(ret->value));
+                ret->value = std::make_unique<VarRefValue>(temp);
+                bb->insts.insert(bb->insts.end() - 1, std::move(result));
+            }
+        }
+    }
+}
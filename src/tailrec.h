@@ -0,0 +1,60 @@
+#ifndef TAILREC_H
+#define TAILREC_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// 尾递归消除
+// 形如 `%r = call @self(args); ret %r` 的自身尾调用不需要新的栈帧：
+// 把实参写回参数的局部副本，再跳回函数开头即可，递归因此变成循环。
+// entry 中参数副本的 store 之后的部分被拆成一个新的循环头块，entry 只保留 alloc 和参数的 store。
+//
+// 对 `ret x + f(...)` / `ret x * f(...)` 这样的线性递归引入累加器 acc（初值为运算的单位元）：
+// 递归处改为 acc = acc op x 后跳回开头，其余的 `ret v` 改为 `ret acc op v`。
+// 整数的加法和乘法（按补码回绕）满足结合律和交换律，因此结果不变。
+//
+// 对其他函数的尾调用在生成汇编时处理（见 visit.cpp 中的 tail 调用）。
+class TailRecursionOptimizer {
+public:
+    TailRecursionOptimizer() = default;
+
+    void optimize(Program* program);
+
+private:
+    // 块末尾的自身递归调用
+    struct TailSite {
+        CallValue* call = nullptr;
+        // 非空时块以 `%s = op %r, x; ret %s` 结束，需要累加到 acc
+        BinaryValue* accumulate = nullptr;
+    };
+
+    void optimize_function(Function* func);
+
+    // 块是否以对自身的（带累加的）尾调用结束
+    bool get_tail_site(const Function* func, BasicBlock* bb, TailSite& site);
+
+    // 把 entry 中参数副本的 store 之后的指令移到新的循环头块，返回该块名
+    std::string split_entry(Function* func);
+
+    // 用参数赋值和跳回循环头替换块末尾的尾调用
+    void replace_tail_call(BasicBlock* bb, const TailSite& site, const std::string& header);
+
+    // 生成新的临时变量名 / 基本块名
+    std::string generate_temp_name();
+    std::string generate_block_name(const Function* func);
+
+    // 当前函数中的变量（alloc 定义），以及第 i 个参数的局部副本
+    std::unordered_set<std::string> variables;
+    std::vector<std::string> param_vars;
+
+    // 累加器变量及其运算（ADD / MUL），没有累加时 acc 为空
+    std::string acc;
+    BinaryOp acc_op;
+
+    static int temp_counter;
+};
+
+#endif // TAILREC_H
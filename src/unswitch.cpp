@@ -0,0 +1,333 @@
+#include "unswitch.h"
+#include <algorithm>
+#include <sstream>
+
+int LoopUnswitchOptimizer::temp_counter = 0;
+
+LoopUnswitchOptimizer::LoopUnswitchOptimizer(int loop_size_limit, int growth_limit)
+    : loop_size_limit(loop_size_limit), growth_limit(growth_limit) {}
+
+std::string LoopUnswitchOptimizer::generate_temp_name() {
+    std::ostringstream oss;
+    oss << "%unswitch_" << temp_counter++;
+    return oss.str();
+}
+
+std::string LoopUnswitchOptimizer::generate_block_name(const Function* func) {
+    std::ostringstream oss;
+    oss << "%" << func->get_func_name() << "_unswitch_" << temp_counter++;
+    return oss.str();
+}
+
+void LoopUnswitchOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+void LoopUnswitchOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+
+    int budget = growth_limit;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        variables.clear();
+        def_count.clear();
+        for (const auto& bb : func->bbs) {
+            for (const auto& inst : bb->insts) {
+                if (inst->v_tag == IRValueTag::ALLOC) {
+                    variables.insert(inst->name);
+                } else if (inst->v_tag != IRValueTag::STORE) {
+                    std::string def = get_def(inst.get());
+                    if (!def.empty()) {
+                        def_count[def]++;
+                    }
+                }
+            }
+        }
+
+        // 每次变换后重新分析，内层循环先处理
+        CFG cfg = build_cfg(func);
+        auto idom = compute_idom(cfg);
+        auto loops = find_loops(cfg, idom);
+        for (const auto& loop : loops) {
+            if (unswitch_loop(func, cfg, loop, budget)) {
+                remove_unreachable_blocks(func);
+                changed = true;
+                break;
+            }
+        }
+    }
+}
+
+bool LoopUnswitchOptimizer::is_invariant(const std::string& name,
+                                         std::vector<const IRValue*>& chain) {
+    if (variables.count(name)) {
+        return stored_in_loop.count(name) == 0;
+    }
+    auto it = loop_defs.find(name);
+    if (it == loop_defs.end()) {
+        // 参数或循环外定义的临时变量
+        return true;
+    }
+    if (def_count[name] != 1) {
+        return false;
+    }
+    const IRValue* inst = it->second;
+    if (std::find(chain.begin(), chain.end(), inst) != chain.end()) {
+        return true;
+    }
+
+    if (inst->v_tag == IRValueTag::LOAD) {
+        auto* load = static_cast<const LoadValue*>(inst);
+        if (load->src->v_tag == IRValueTag::VAR_REF && !is_invariant(load->src->name, chain)) {
+            return false;
+        }
+    } else if (inst->v_tag == IRValueTag::BINARY) {
+        auto* bin = static_cast<const BinaryValue*>(inst);
+        // 条件会被提到循环之前无条件执行，不能引入新的除零
+        if (bin->op == BinaryOp::DIV || bin->op == BinaryOp::MOD) {
+            if (bin->rhs->v_tag != IRValueTag::INTEGER ||
+                static_cast<const IntergerValue*>(bin->rhs.get())->value == 0) {
+                return false;
+            }
+        }
+        for (const IRValue* op : {bin->lhs.get(), bin->rhs.get()}) {
+            if (op->v_tag == IRValueTag::VAR_REF && !is_invariant(op->name, chain)) {
+                return false;
+            }
+        }
+    } else {
+        return false;
+    }
+    chain.push_back(inst);
+    return true;
+}
+
+BasicBlock* LoopUnswitchOptimizer::get_preheader(Function* func, const CFG& cfg,
+                                                 const Loop& loop) {
+    std::vector<int> outside;
+    for (int p : cfg.preds[loop.header]) {
+        if (!loop.blocks.count(p)) {
+            outside.push_back(p);
+        }
+    }
+    if (outside.size() == 1 && func->bbs[outside[0]]->insts.back()->v_tag == IRValueTag::JUMP) {
+        return func->bbs[outside[0]].get();
+    }
+
+    // 新建前置块，所有从循环外进入循环头的边都改为进入前置块
+    std::string header = func->bbs[loop.header]->name;
+    std::string name = generate_block_name(func);
+    for (int p : outside) {
+        IRValue* term = func->bbs[p]->insts.back().get();
+        if (term->v_tag == IRValueTag::JUMP) {
+            static_cast<JumpValue*>(term)->target_block = name;
+        } else if (term->v_tag == IRValueTag::BRANCH) {
+            auto* br = static_cast<BranchValue*>(term);
+            if (br->true_block == header) br->true_block = name;
+            if (br->false_block == header) br->false_block = name;
+        }
+    }
+    auto pre = std::make_unique<BasicBlock>(name);
+    pre->add_inst(std::make_unique<JumpValue>(header));
+    BasicBlock* pre_bb = pre.get();
+    func->bbs.insert(func->bbs.begin() + loop.header, std::move(pre));
+    return pre_bb;
+}
+
+bool LoopUnswitchOptimizer::unswitch_loop(Function* func, const CFG& cfg, const Loop& loop,
+                                          int& budget) {
+    auto& bbs = func->bbs;
+    if (loop.header == 0) {
+        return false;
+    }
+
+    int size = 0;
+    stored_in_loop.clear();
+    loop_defs.clear();
+    for (int b : loop.blocks) {
+        size += bbs[b]->insts.size();
+        for (const auto& inst : bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::STORE) {
+                stored_in_loop.insert(get_def(inst.get()));
+            } else if (inst->v_tag != IRValueTag::ALLOC) {
+                std::string def = get_def(inst.get());
+                if (!def.empty()) {
+                    loop_defs[def] = inst.get();
+                }
+            }
+        }
+    }
+    if (size > loop_size_limit || size > budget) {
+        return false;
+    }
+
+    // 找到条件为循环不变量、两个目标都在循环内的分支
+    int switch_block = -1;
+    std::vector<const IRValue*> chain;
+    for (int b : loop.blocks) {
+        const IRValue* term = bbs[b]->insts.back().get();
+        if (term->v_tag != IRValueTag::BRANCH) {
+            continue;
+        }
+        auto* br = static_cast<const BranchValue*>(term);
+        if (br->true_block == br->false_block || br->cond->v_tag != IRValueTag::VAR_REF ||
+            !loop.blocks.count(cfg.index.at(br->true_block)) ||
+            !loop.blocks.count(cfg.index.at(br->false_block))) {
+            continue;
+        }
+        chain.clear();
+        if (is_invariant(br->cond->name, chain)) {
+            switch_block = b;
+            break;
+        }
+    }
+    if (switch_block == -1) {
+        return false;
+    }
+
+    // 以下按名字操作，插入前置块会改变下标
+    std::vector<BasicBlock*> loop_bbs;
+    for (int b : loop.blocks) {
+        loop_bbs.push_back(bbs[b].get());
+    }
+    BasicBlock* switch_bb = bbs[switch_block].get();
+    std::string header = bbs[loop.header]->name;
+    std::string last_block = bbs[*loop.blocks.rbegin()]->name;
+
+    BasicBlock* pre_bb = get_preheader(func, cfg, loop);
+
+    // 在前置块中重新计算条件
+    std::unordered_map<std::string, std::string> rename;
+    auto apply_rename = [&](IRValue* inst) {
+        for (auto* op : get_operands(inst)) {
+            auto it = rename.find((*op)->name);
+            if ((*op)->v_tag == IRValueTag::VAR_REF && it != rename.end()) {
+                *op = std::make_unique<VarRefValue>(it->second);
+            }
+        }
+    };
+    pre_bb->insts.pop_back();
+    for (const IRValue* inst : chain) {
+        auto copy = clone_inst(inst);
+        apply_rename(copy.get());
+        copy->name = generate_temp_name();
+        rename[inst->name] = copy->name;
+        pre_bb->add_inst(std::move(copy));
+    }
+    auto* switch_br = static_cast<BranchValue*>(switch_bb->insts.back().get());
+    std::string cond = switch_br->cond->name;
+    if (rename.count(cond)) {
+        cond = rename[cond];
+    }
+
+    // 复制循环，循环内的块名和只在循环内使用的临时变量都改名
+    std::unordered_map<std::string, std::string> block_map;
+    for (BasicBlock* bb : loop_bbs) {
+        block_map[bb->name] = generate_block_name(func);
+    }
+    std::unordered_set<std::string> used_outside;
+    for (const auto& bb : bbs) {
+        if (std::find(loop_bbs.begin(), loop_bbs.end(), bb.get()) != loop_bbs.end()) {
+            continue;
+        }
+        for (const auto& inst : bb->insts) {
+            for (auto* op : get_operands(inst.get())) {
+                used_outside.insert((*op)->name);
+            }
+        }
+    }
+    rename.clear();
+    for (const auto& [name, inst] : loop_defs) {
+        if (!used_outside.count(name)) {
+            rename[name] = generate_temp_name();
+        }
+    }
+    auto map_block = [&](std::string& target) {
+        auto it = block_map.find(target);
+        if (it != block_map.end()) {
+            target = it->second;
+        }
+    };
+
+    std::vector<std::unique_ptr<BasicBlock>> clones;
+    for (BasicBlock* bb : loop_bbs) {
+        auto copy = std::make_unique<BasicBlock>(block_map[bb->name]);
+        for (const auto& inst : bb->insts) {
+            auto c = clone_inst(inst.get());
+            apply_rename(c.get());
+            if (c->v_tag != IRValueTag::STORE && rename.count(c->name)) {
+                c->name = rename[c->name];
+            }
+            if (c->v_tag == IRValueTag::BRANCH) {
+                auto* br = static_cast<BranchValue*>(c.get());
+                map_block(br->true_block);
+                map_block(br->false_block);
+            } else if (c->v_tag == IRValueTag::JUMP) {
+                map_block(static_cast<JumpValue*>(c.get())->target_block);
+            }
+            copy->add_inst(std::move(c));
+        }
+        clones.push_back(std::move(copy));
+    }
+
+    // 原循环固定走 true 一侧，副本固定走 false 一侧
+    std::string true_block = switch_br->true_block;
+    std::string false_block = block_map[switch_br->false_block];
+    BasicBlock* switch_clone = clones[std::find(loop_bbs.begin(), loop_bbs.end(), switch_bb) -
+                                      loop_bbs.begin()].get();
+    switch_bb->insts.back() = std::make_unique<JumpValue>(true_block);
+    switch_clone->insts.back() = std::make_unique<JumpValue>(false_block);
+
+    // 两个版本各自有一个以 jump 结尾的前置块，便于后续的循环优化
+    auto true_pre = std::make_unique<BasicBlock>(generate_block_name(func));
+    auto false_pre = std::make_unique<BasicBlock>(generate_block_name(func));
+    true_pre->add_inst(std::make_unique<JumpValue>(header));
+    false_pre->add_inst(std::make_unique<JumpValue>(block_map[header]));
+    pre_bb->add_inst(std::make_unique<BranchValue>(std::make_unique<VarRefValue>(cond),
+                                                   true_pre->name, false_pre->name));
+    clones.insert(clones.begin(), std::move(false_pre));
+
+    auto find_block = [&](const std::string& name) {
+        return std::find_if(bbs.begin(), bbs.end(), [&](const std::unique_ptr<BasicBlock>& bb) {
+            return bb->name == name;
+        });
+    };
+    bbs.insert(find_block(header), std::move(true_pre));
+
+    // 副本放在原循环最后一个块之后
+    bbs.insert(find_block(last_block) + 1, std::make_move_iterator(clones.begin()),
+               std::make_move_iterator(clones.end()));
+
+    // 删除不再使用的条件计算
+    for (BasicBlock* bb : {switch_bb, switch_clone}) {
+        bool removed = true;
+        while (removed) {
+            removed = false;
+            std::unordered_set<std::string> used;
+            for (const auto& block : bbs) {
+                for (const auto& inst : block->insts) {
+                    for (auto* op : get_operands(inst.get())) {
+                        used.insert((*op)->name);
+                    }
+                }
+            }
+            auto& insts = bb->insts;
+            for (size_t i = 0; i < insts.size(); i++) {
+                IRValue* inst = insts[i].get();
+                if ((inst->v_tag == IRValueTag::LOAD || inst->v_tag == IRValueTag::BINARY) &&
+                    !used.count(inst->name) && def_count[inst->name] <= 1) {
+                    insts.erase(insts.begin() + i);
+                    removed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    budget -= size;
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef UNSWITCH_H
+#define UNSWITCH_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+// 循环外提（loop unswitching）优化器
+// 循环体内条件只依赖循环不变量的分支，每轮迭代都要重新判断一次。
+// 把整个循环复制一份，在循环前判断一次条件：
+//   原循环中该分支固定走 true 一侧，副本中固定走 false 一侧。
+// 复制会使代码膨胀，因此限制单个循环的大小和每个函数的总增长量。
+class LoopUnswitchOptimizer {
+public:
+    LoopUnswitchOptimizer(int loop_size_limit = 64, int growth_limit = 256);
+
+    void optimize(Program* program);
+
+private:
+    // 可复制的循环的最大指令数
+    int loop_size_limit;
+
+    // 每个函数因复制而增加的最大指令数
+    int growth_limit;
+
+    void optimize_function(Function* func);
+
+    // 尝试对一个循环做外提，成功返回 true（此时 CFG 已改变）
+    bool unswitch_loop(Function* func, const CFG& cfg, const Loop& loop, int& budget);
+
+    // 条件在循环中是否不变，不变时把计算它的循环内指令按顺序放入 chain
+    bool is_invariant(const std::string& name, std::vector<const IRValue*>& chain);
+
+    // 为循环准备唯一的、以 jump 结尾的前置块
+    BasicBlock* get_preheader(Function* func, const CFG& cfg, const Loop& loop);
+
+    // 生成新的临时变量名 / 基本块名
+    std::string generate_temp_name();
+    std::string generate_block_name(const Function* func);
+
+    // 当前函数中的变量（alloc 定义）以及每个名字的定义次数
+    std::unordered_set<std::string> variables;
+    std::unordered_map<std::string, int> def_count;
+
+    // 当前循环中被 store 的变量，以及循环中定义的临时变量 -> 定义指令
+    std::unordered_set<std::string> stored_in_loop;
+    std::unordered_map<std::string, const IRValue*> loop_defs;
+
+    static int temp_counter;
+};
+
+#endif // UNSWITCH_H
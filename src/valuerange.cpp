@@ -0,0 +1,556 @@
+#include "valuerange.h"
+#include <algorithm>
+
+using Fact = ValueRangeOptimizer::Fact;
+
+namespace {
+
+// x 的最高位及以下全为 1 的掩码
+uint32_t fill_below(uint32_t x) {
+    x |= x >> 1;
+    x |= x >> 2;
+    x |= x >> 4;
+    x |= x >> 8;
+    x |= x >> 16;
+    return x;
+}
+
+// 低位连续已知为 0 的位数
+int trailing_zeros(const Fact& f) {
+    int k = 0;
+    while (k < 32 && (f.zero >> k & 1)) {
+        k++;
+    }
+    return k;
+}
+
+uint32_t low_mask(int k) {
+    return k >= 32 ? 0xffffffffu : (1u << k) - 1;
+}
+
+bool known_nonzero(const Fact& f) {
+    return f.lo > 0 || f.hi < 0 || f.one != 0;
+}
+
+} // namespace
+
+Fact Fact::full() {
+    Fact f;
+    f.empty = false;
+    return f;
+}
+
+Fact Fact::constant(int32_t c) {
+    Fact f;
+    f.empty = false;
+    f.lo = f.hi = c;
+    f.one = static_cast<uint32_t>(c);
+    f.zero = ~f.one;
+    return f;
+}
+
+Fact Fact::range(int64_t lo, int64_t hi) {
+    if (lo < INT32_MIN || hi > INT32_MAX) {
+        return full();
+    }
+    Fact f;
+    f.empty = false;
+    f.lo = lo;
+    f.hi = hi;
+    f.normalize();
+    return f;
+}
+
+void Fact::normalize() {
+    if (empty) {
+        return;
+    }
+    // 区间在同一符号内时，lo 与 hi 的公共高位已知
+    if ((lo >= 0) == (hi >= 0) && lo <= hi) {
+        uint32_t ulo = static_cast<uint32_t>(lo), uhi = static_cast<uint32_t>(hi);
+        uint32_t prefix = ~fill_below(ulo ^ uhi);
+        one |= ulo & prefix;
+        zero |= ~ulo & prefix;
+    }
+    // 已知符号位时，已知位给出区间
+    if (zero & 0x80000000u) {
+        lo = std::max<int64_t>(lo, static_cast<int32_t>(one));
+        hi = std::min<int64_t>(hi, static_cast<int32_t>(~zero));
+    } else if (one & 0x80000000u) {
+        lo = std::max<int64_t>(lo, static_cast<int32_t>(one));
+        hi = std::min<int64_t>(hi, static_cast<int32_t>(~zero));
+    }
+    if (lo > hi || (zero & one)) {
+        *this = Fact();
+    } else if (lo == hi) {
+        one = static_cast<uint32_t>(lo);
+        zero = ~one;
+    }
+}
+
+Fact Fact::join(const Fact& other) const {
+    if (empty) {
+        return other;
+    }
+    if (other.empty) {
+        return *this;
+    }
+    Fact f;
+    f.empty = false;
+    f.lo = std::min(lo, other.lo);
+    f.hi = std::max(hi, other.hi);
+    f.zero = zero & other.zero;
+    f.one = one & other.one;
+    f.normalize();
+    return f;
+}
+
+Fact Fact::meet(const Fact& other) const {
+    if (empty || other.empty) {
+        return Fact();
+    }
+    Fact f;
+    f.empty = false;
+    f.lo = std::max(lo, other.lo);
+    f.hi = std::min(hi, other.hi);
+    f.zero = zero | other.zero;
+    f.one = one | other.one;
+    f.normalize();
+    return f;
+}
+
+bool Fact::operator==(const Fact& other) const {
+    if (empty || other.empty) {
+        return empty == other.empty;
+    }
+    return lo == other.lo && hi == other.hi && zero == other.zero && one == other.one;
+}
+
+ValueRangeOptimizer::ValueRangeOptimizer(int widen_rounds) : widen_rounds(widen_rounds) {}
+
+void ValueRangeOptimizer::optimize(Program* program) {
+    for (auto& func : program->funcs) {
+        optimize_function(func.get());
+    }
+}
+
+Fact ValueRangeOptimizer::eval(BinaryOp op, const Fact& l, const Fact& r) {
+    if (l.empty || r.empty) {
+        return Fact();
+    }
+
+    // 两个操作数都是常量时按 RV32 的语义直接计算
+    int folded;
+    if (l.is_const() && r.is_const() &&
+        fold_binary_const(op, static_cast<int>(l.lo), static_cast<int>(r.lo), folded)) {
+        return Fact::constant(folded);
+    }
+
+    Fact f = Fact::full();
+    switch (op) {
+        case BinaryOp::ADD:
+        case BinaryOp::SUB: {
+            f = op == BinaryOp::ADD ? Fact::range(l.lo + r.lo, l.hi + r.hi) : Fact::range(l.lo - r.hi, l.hi - r.lo);
+            f.zero |= low_mask(std::min(trailing_zeros(l), trailing_zeros(r)));
+            break;
+        }
+        case BinaryOp::MUL: {
+            int64_t c[] = {l.lo * r.lo, l.lo * r.hi, l.hi * r.lo, l.hi * r.hi};
+            f = Fact::range(*std::min_element(c, c + 4), *std::max_element(c, c + 4));
+            f.zero |= low_mask(std::min(32, trailing_zeros(l) + trailing_zeros(r)));
+            break;
+        }
+        case BinaryOp::DIV:
+            if (r.is_const() && r.lo != 0 && r.lo != -1) {
+                int64_t a = l.lo / r.lo, b = l.hi / r.lo;
+                f = Fact::range(std::min(a, b), std::max(a, b));
+            }
+            break;
+        case BinaryOp::MOD:
+            if (r.is_const() && r.lo != 0) {
+                int64_t m = std::abs(r.lo) - 1;
+                if (l.lo >= 0) {
+                    f = Fact::range(0, std::min(m, l.hi));
+                } else if (l.hi <= 0) {
+                    f = Fact::range(std::max(-m, l.lo), 0);
+                } else {
+                    f = Fact::range(-m, m);
+                }
+            }
+            break;
+        case BinaryOp::AND:
+            if (l.lo >= 0 || r.lo >= 0) {
+                int64_t hi = INT32_MAX;
+                if (l.lo >= 0) hi = std::min(hi, l.hi);
+                if (r.lo >= 0) hi = std::min(hi, r.hi);
+                f = Fact::range(0, hi);
+            }
+            f.zero |= l.zero | r.zero;
+            f.one |= l.one & r.one;
+            break;
+        case BinaryOp::OR:
+            f.zero |= l.zero & r.zero;
+            f.one |= l.one | r.one;
+            break;
+        case BinaryOp::XOR:
+            f.zero |= (l.zero & r.zero) | (l.one & r.one);
+            f.one |= (l.zero & r.one) | (l.one & r.zero);
+            break;
+        case BinaryOp::SHL:
+            if (r.is_const()) {
+                int k = r.lo & 31;
+                f = Fact::range(l.lo * (int64_t(1) << k), l.hi * (int64_t(1) << k));
+                f.zero |= (l.zero << k) | low_mask(k);
+                f.one |= l.one << k;
+            }
+            break;
+        case BinaryOp::SHR:
+            if (r.is_const() && (r.lo & 31) != 0) {
+                int k = r.lo & 31;
+                f.zero |= (l.zero >> k) | ~(0xffffffffu >> k);
+                f.one |= l.one >> k;
+            } else if (r.is_const()) {
+                f = l;
+            }
+            break;
+        case BinaryOp::SAR:
+            if (r.is_const()) {
+                int k = r.lo & 31;
+                f = Fact::range(l.lo >> k, l.hi >> k);
+                f.zero |= static_cast<uint32_t>(static_cast<int32_t>(l.zero) >> k);
+                f.one |= static_cast<uint32_t>(static_cast<int32_t>(l.one) >> k);
+            }
+            break;
+        case BinaryOp::CZERO_EQZ:
+            // r == 0 ? 0 : l
+            if (known_nonzero(r)) return l;
+            if (r.is_const()) return Fact::constant(0);
+            return l.join(Fact::constant(0));
+        case BinaryOp::CZERO_NEZ:
+            // r != 0 ? 0 : l
+            if (known_nonzero(r)) return Fact::constant(0);
+            if (r.is_const()) return l;
+            return l.join(Fact::constant(0));
+        default: {
+            // 比较，结果为 0 或 1
+            bool always = false, never = false;
+            switch (op) {
+                case BinaryOp::LT: always = l.hi < r.lo; never = l.lo >= r.hi; break;
+                case BinaryOp::LE: always = l.hi <= r.lo; never = l.lo > r.hi; break;
+                case BinaryOp::GT: always = l.lo > r.hi; never = l.hi <= r.lo; break;
+                case BinaryOp::GE: always = l.lo >= r.hi; never = l.hi < r.lo; break;
+                case BinaryOp::EQ:
+                case BinaryOp::NE: {
+                    bool differ = l.hi < r.lo || r.hi < l.lo || (l.one & r.zero) || (l.zero & r.one);
+                    bool equal = l.is_const() && r.is_const() && l.lo == r.lo;
+                    always = op == BinaryOp::EQ ? equal : differ;
+                    never = op == BinaryOp::EQ ? differ : equal;
+                    break;
+                }
+                default: return Fact::full();
+            }
+            return always ? Fact::constant(1) : never ? Fact::constant(0) : Fact::range(0, 1);
+        }
+    }
+    f.normalize();
+    return f.empty ? Fact::full() : f;
+}
+
+void ValueRangeOptimizer::compute_facts(const Function* func, const std::vector<int>& idom) {
+    facts.clear();
+    variables.clear();
+    def_count.clear();
+    for (const auto& bb : func->bbs) {
+        for (const auto& inst : bb->insts) {
+            if (inst->v_tag == IRValueTag::ALLOC) {
+                variables.insert(inst->name);
+            } else if (!inst->name.empty() && inst->v_tag != IRValueTag::STORE) {
+                def_count[inst->name]++;
+            }
+        }
+    }
+
+    std::unordered_map<std::string, int> rounds;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int b = 0; b < static_cast<int>(func->bbs.size()); b++) {
+            // 定义处成立的细化也适用于定义的值
+            auto operand = [&](const IRValue* v) { return fact_at(v, b, idom); };
+            for (const auto& inst : func->bbs[b]->insts) {
+                std::string name;
+                Fact value;
+                if (inst->v_tag == IRValueTag::STORE) {
+                    auto* store = static_cast<StoreValue*>(inst.get());
+                    name = store->dest->name;
+                    value = operand(store->value.get());
+                } else if (inst->v_tag == IRValueTag::BINARY) {
+                    auto* bin = static_cast<BinaryValue*>(inst.get());
+                    name = bin->name;
+                    value = eval(bin->op, operand(bin->lhs.get()), operand(bin->rhs.get()));
+                } else if (inst->v_tag == IRValueTag::LOAD) {
+                    name = inst->name;
+                    value = operand(static_cast<LoadValue*>(inst.get())->src.get());
+                } else if (inst->v_tag == IRValueTag::CALL) {
+                    name = inst->name;
+                    value = Fact::full();
+                } else {
+                    continue;
+                }
+
+                // 变量和多次定义的名字取所有定义的并
+                auto& fact = facts[name];
+                int& round = rounds[name];
+                if (round > widen_rounds) {
+                    continue;
+                }
+                if (!is_temp(name)) {
+                    value = fact.join(value);
+                }
+                if (value != fact) {
+                    fact = ++round > widen_rounds ? Fact::full() : value;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+void ValueRangeOptimizer::collect_refinements(const Function* func, const CFG& cfg,
+                                              const std::vector<int>& idom) {
+    refinements.clear();
+    const auto& bbs = func->bbs;
+    int n = bbs.size();
+
+    std::unordered_map<std::string, const BinaryValue*> compare_defs;
+    std::vector<std::unordered_set<std::string>> stored(n);
+    for (int b = 0; b < n; b++) {
+        for (const auto& inst : bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::STORE) {
+                stored[b].insert(get_def(inst.get()));
+            } else if (inst->v_tag == IRValueTag::BINARY && is_temp(inst->name)) {
+                compare_defs[inst->name] = static_cast<const BinaryValue*>(inst.get());
+            }
+        }
+    }
+
+    // 变量在块 target 支配的区域中是否被 store
+    auto stored_in_region = [&](int target, const std::string& var) {
+        for (int b = 0; b < n; b++) {
+            if (stored[b].count(var) && dominates(idom, target, b)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for (int b = 0; b < n; b++) {
+        const auto& insts = bbs[b]->insts;
+        if (insts.back()->v_tag != IRValueTag::BRANCH) {
+            continue;
+        }
+        auto* br = static_cast<const BranchValue*>(insts.back().get());
+        if (br->true_block == br->false_block || br->cond->v_tag != IRValueTag::VAR_REF) {
+            continue;
+        }
+
+        // 比较的操作数 x：只定义一次的临时变量，或在本块中读取、此后未被 store 的变量
+        const BinaryValue* cmp = nullptr;
+        auto it = compare_defs.find(br->cond->name);
+        if (it != compare_defs.end() && is_compare(it->second->op)) {
+            cmp = it->second;
+        }
+        const IRValue* x = nullptr;
+        BinaryOp op = BinaryOp::NE;
+        int64_t k = 0;
+        std::string loaded_var;
+        if (cmp) {
+            const IRValue* lhs = cmp->lhs.get();
+            const IRValue* rhs = cmp->rhs.get();
+            op = cmp->op;
+            if (lhs->v_tag == IRValueTag::INTEGER) {
+                std::swap(lhs, rhs);
+                op = swap_compare(op);
+            }
+            if (rhs->v_tag == IRValueTag::INTEGER && lhs->v_tag == IRValueTag::VAR_REF) {
+                x = lhs;
+                k = static_cast<const IntergerValue*>(rhs)->value;
+            }
+        }
+
+        // 在本块中 pos 之后是否 store 了 var
+        auto stored_after = [&](const IRValue* inst, const std::string& var) {
+            bool after = false;
+            for (const auto& other : insts) {
+                if (after && other->v_tag == IRValueTag::STORE && get_def(other.get()) == var) {
+                    return true;
+                }
+                after |= other.get() == inst;
+            }
+            return !after;
+        };
+        if (x && is_temp(x->name)) {
+            for (const auto& inst : insts) {
+                if (inst->name == x->name && inst->v_tag == IRValueTag::LOAD) {
+                    const IRValue* src = static_cast<const LoadValue*>(inst.get())->src.get();
+                    if (variables.count(src->name) && !stored_after(inst.get(), src->name)) {
+                        loaded_var = src->name;
+                    }
+                }
+            }
+        } else if (x && variables.count(x->name) && !stored_after(cmp, x->name)) {
+            loaded_var = x->name;
+        } else {
+            x = nullptr;
+        }
+
+        for (bool truth : {true, false}) {
+            int target = cfg.index.at(truth ? br->true_block : br->false_block);
+            if (target == b || cfg.preds[target].size() != 1) {
+                continue;
+            }
+
+            // 条件本身
+            if (is_temp(br->cond->name)) {
+                const Fact& c = facts[br->cond->name];
+                if (!truth) {
+                    refinements.push_back({target, br->cond->name, Fact::constant(0)});
+                } else if (!c.empty && c.lo >= 0) {
+                    refinements.push_back({target, br->cond->name, Fact::range(1, INT32_MAX)});
+                }
+            }
+            if (!x) {
+                continue;
+            }
+
+            Fact f;
+            BinaryOp edge_op = truth ? op : negate_compare(op);
+            const Fact& base = facts[x->name];
+            switch (edge_op) {
+                case BinaryOp::LT: f = Fact::range(INT32_MIN, k - 1); break;
+                case BinaryOp::LE: f = Fact::range(INT32_MIN, k); break;
+                case BinaryOp::GT: f = Fact::range(k + 1, INT32_MAX); break;
+                case BinaryOp::GE: f = Fact::range(k, INT32_MAX); break;
+                case BinaryOp::EQ: f = Fact::constant(static_cast<int32_t>(k)); break;
+                default:
+                    // x != k 只能去掉区间的端点
+                    if (!base.empty && base.lo == k) {
+                        f = Fact::range(k + 1, INT32_MAX);
+                    } else if (!base.empty && base.hi == k) {
+                        f = Fact::range(INT32_MIN, k - 1);
+                    }
+                    break;
+            }
+            if (f.empty) {
+                continue;
+            }
+            if (is_temp(x->name)) {
+                refinements.push_back({target, x->name, f});
+            }
+            if (!loaded_var.empty() && !stored_in_region(target, loaded_var)) {
+                refinements.push_back({target, loaded_var, f});
+            }
+        }
+    }
+}
+
+bool ValueRangeOptimizer::is_temp(const std::string& name) const {
+    auto it = def_count.find(name);
+    return it != def_count.end() && it->second == 1 && !variables.count(name);
+}
+
+Fact ValueRangeOptimizer::fact_at(const IRValue* v, int block, const std::vector<int>& idom) const {
+    Fact f;
+    if (v->v_tag == IRValueTag::INTEGER) {
+        return Fact::constant(static_cast<const IntergerValue*>(v)->value);
+    }
+    auto it = facts.find(v->name);
+    if (it != facts.end()) {
+        f = it->second;
+    } else if (!variables.count(v->name) && !def_count.count(v->name)) {
+        f = Fact::full();
+    }
+    for (const auto& r : refinements) {
+        if (r.name == v->name && dominates(idom, r.block, block)) {
+            f = f.meet(r.fact);
+        }
+    }
+    return f;
+}
+
+void ValueRangeOptimizer::optimize_function(Function* func) {
+    normalize_terminators(func);
+    remove_unreachable_blocks(func);
+
+    auto& bbs = func->bbs;
+    int n = bbs.size();
+    CFG cfg = build_cfg(func);
+    auto idom = compute_idom(cfg);
+    refinements.clear();
+    compute_facts(func, idom);
+    collect_refinements(func, cfg, idom);
+    compute_facts(func, idom);
+
+    for (int b = 0; b < n; b++) {
+        for (auto& inst : bbs[b]->insts) {
+            if (inst->v_tag == IRValueTag::BRANCH) {
+                auto* br = static_cast<BranchValue*>(inst.get());
+                Fact c = fact_at(br->cond.get(), b, idom);
+                if (c.is_const() || (!c.empty && known_nonzero(c))) {
+                    inst = std::make_unique<JumpValue>(c.is_const() && c.lo == 0 ? br->false_block : br->true_block);
+                }
+                continue;
+            }
+            if (inst->v_tag != IRValueTag::BINARY) {
+                continue;
+            }
+
+            auto* bin = static_cast<BinaryValue*>(inst.get());
+            Fact l = fact_at(bin->lhs.get(), b, idom);
+            Fact r = fact_at(bin->rhs.get(), b, idom);
+            Fact result = eval(bin->op, l, r);
+            if (result.is_const()) {
+                inst = std::make_unique<LoadValue>(bin->name, std::make_unique<IntergerValue>(result.lo), 1);
+                continue;
+            }
+            if (l.empty || r.empty) {
+                continue;
+            }
+
+            // 常量放在右边
+            const IRValue* x = bin->lhs.get();
+            Fact fx = l;
+            const IRValue* c = bin->rhs.get();
+            bool commutative = bin->op == BinaryOp::AND || bin->op == BinaryOp::OR ||
+                               bin->op == BinaryOp::EQ || bin->op == BinaryOp::NE;
+            if (commutative && x->v_tag == IRValueTag::INTEGER) {
+                std::swap(x, c);
+                fx = r;
+            }
+            if (c->v_tag != IRValueTag::INTEGER) {
+                continue;
+            }
+            uint32_t m = static_cast<uint32_t>(static_cast<const IntergerValue*>(c)->value);
+            int32_t k = static_cast<int32_t>(m);
+
+            bool copy = false;
+            switch (bin->op) {
+                case BinaryOp::NE: copy = k == 0 && fx.is_boolean(); break;
+                case BinaryOp::AND: copy = (~fx.zero & ~m) == 0; break;
+                case BinaryOp::OR: copy = (m & ~fx.one) == 0; break;
+                case BinaryOp::MOD: copy = k != 0 && fx.lo >= 0 && fx.hi < std::abs(static_cast<int64_t>(k)); break;
+                case BinaryOp::EQ:
+                    if (k == 0 && fx.is_boolean()) {
+                        inst = std::make_unique<BinaryValue>(bin->name, BinaryOp::XOR, clone_inst(x),
+                                                             std::make_unique<IntergerValue>(1));
+                    }
+                    break;
+                default: break;
+            }
+            if (copy) {
+                inst = std::make_unique<LoadValue>(bin->name, clone_inst(x), 0);
+            }
+        }
+    }
+    remove_unreachable_blocks(func);
+}
@@ -0,0 +1,84 @@
+#ifndef VALUERANGE_H
+#define VALUERANGE_H
+
+#include "IR.h"
+#include "cfg.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 已知位与整数区间分析，以及基于它的比较和布尔运算化简。
+// 每个只定义一次的临时变量有一个全局的事实（区间 [lo, hi] 与已知为 0/1 的位），
+// 变量的事实为其所有 store 的值的并（与位置无关）；循环中反复变化的事实被放宽到整个 int 范围。
+// 分支 br (x op c) 的两个后继若只有这一个前驱，则在其支配的块中 x 满足 op（或其否定），
+// 变量只有在该区域中没有被 store 时才这样细化。
+// 利用这些事实：
+// 1. 结果已知的运算（如 n >= 0 在 n 已知非负时）变为 li，条件已知的分支变为 jump；
+// 2. 已知为 0/1 的值上的 ne x, 0 变为复制，eq x, 0 变为 xor x, 1；
+// 3. 不改变任何可能为 1 的位的 and/or 掩码、不改变值的 mod/div 变为复制。
+class ValueRangeOptimizer {
+public:
+    ValueRangeOptimizer(int widen_rounds = 3);
+
+    void optimize(Program* program);
+
+    // 一个值的已知信息
+    struct Fact {
+        bool empty = true;           // 尚未得到任何值（格的底）
+        int64_t lo = INT32_MIN;
+        int64_t hi = INT32_MAX;
+        uint32_t zero = 0;           // 已知为 0 的位
+        uint32_t one = 0;            // 已知为 1 的位
+
+        static Fact full();
+        static Fact constant(int32_t c);
+        static Fact range(int64_t lo, int64_t hi);
+
+        bool is_const() const { return !empty && lo == hi; }
+        bool is_boolean() const { return !empty && lo >= 0 && hi <= 1; }
+
+        // 区间与已知位互相推导
+        void normalize();
+        Fact join(const Fact& other) const;
+        Fact meet(const Fact& other) const;
+        bool operator==(const Fact& other) const;
+        bool operator!=(const Fact& other) const { return !(*this == other); }
+    };
+
+private:
+    // 变化超过该轮数的事实放宽到整个范围
+    int widen_rounds;
+
+    // 分支边上成立的条件：在 block 支配的块中，name 的事实与 fact 取交
+    struct Refinement {
+        int block;
+        std::string name;
+        Fact fact;
+    };
+
+    void optimize_function(Function* func);
+
+    // 计算所有临时变量和变量的全局事实，操作数的事实取定义处已收集的细化
+    void compute_facts(const Function* func, const std::vector<int>& idom);
+
+    // 收集分支边上的细化
+    void collect_refinements(const Function* func, const CFG& cfg, const std::vector<int>& idom);
+
+    // 是否为只定义一次的临时变量
+    bool is_temp(const std::string& name) const;
+
+    // 在块 block 中读取操作数 v 的事实
+    Fact fact_at(const IRValue* v, int block, const std::vector<int>& idom) const;
+
+    // 二元运算的结果
+    static Fact eval(BinaryOp op, const Fact& lhs, const Fact& rhs);
+
+    std::unordered_map<std::string, Fact> facts;
+    std::unordered_set<std::string> variables;
+    std::unordered_map<std::string, int> def_count;
+    std::vector<Refinement> refinements;
+};
+
+#endif // VALUERANGE_H
@@ -1,12 +1,15 @@
 ﻿#include "visit.h"
 #include "rv_defs.h"
 #include "register_allocation.h"
+#include "rv_lowering.h"
+#include "cfg.h"
 
 #include <cassert>
 #include <cstring>
 #include <iostream>
 #include <sstream>
 #include <unordered_map>
+#include <unordered_set>
 
 static std::unordered_map<std::string, int> func_param_counts;
 
@@ -26,6 +29,12 @@ static int stack_size;
 static int cur_local_var_index;
 static std::unordered_map<std::string, Position> local_var_indices;
 
+// values known to be 0 or 1 (results of comparisons) in the current function
+static std::unordered_set<std::string> boolean_values;
+
+// the block laid out right after the current one, jumps to it fall through
+static std::string fallthrough_block;
+
 Position get_local_var_index(std::string var_name) {
     //std::cout << "looking for local variable " << var_name << "\n";
     if (strncmp(var_name.c_str(), "$imm_", 5) == 0) {
@@ -51,9 +60,60 @@ std::string visit_program(std::unique_ptr<Program> program) {
     std::ostringstream oss;
     oss << "  .globl main\n";
     for (const auto &func : program->funcs) {
+        if (func->memo_table_size > 0) {
+            oss << visit_memo_wrapper(func.get()) << "\n";
+        }
         oss << visit_function(std::move(func)) << "\n";
     }
 
+    // memo tables, 8 bytes per entry: valid flag and value
+    bool has_memo = false;
+    for (const auto &func : program->funcs) {
+        if (func->memo_table_size > 0) {
+            if (!has_memo) {
+                oss << "  .bss\n";
+                oss << "  .align 2\n";
+                has_memo = true;
+            }
+            oss << func->get_func_name() << "_memo_table:\n";
+            oss << "  .space " << 8 * func->memo_table_size << "\n";
+        }
+    }
+
+    return oss.str();
+}
+
+std::string visit_memo_wrapper(const Function* func) {
+    std::ostringstream oss;
+    std::string name = func->get_func_name();
+
+    // the wrapper takes the function's name, the original code is visited under name_memo_body.
+    // arguments outside [0, size) go straight to the original code.
+    oss << name << ":\n";
+    oss << "  li t0, " << func->memo_table_size << "\n";
+    oss << "  bgeu a0, t0, " << name << "_memo_body\n";
+    oss << "  la t1, " << name << "_memo_table\n";
+    oss << "  slli t2, a0, 3\n";
+    oss << "  add t1, t1, t2\n";
+    oss << "  lw t2, 0(t1)\n";
+    oss << "  beqz t2, " << name << "_memo_miss\n";
+    oss << "  lw a0, 4(t1)\n";
+    oss << "  ret\n";
+
+    // miss: compute, then fill the entry
+    oss << name << "_memo_miss:\n";
+    oss << "  addi sp, sp, -16\n";
+    oss << "  sw ra, 12(sp)\n";
+    oss << "  sw t1, 8(sp)\n";
+    oss << "  call " << name << "_memo_body\n";
+    oss << "  lw t1, 8(sp)\n";
+    oss << "  sw a0, 4(t1)\n";
+    oss << "  li t2, 1\n";
+    oss << "  sw t2, 0(t1)\n";
+    oss << "  lw ra, 12(sp)\n";
+    oss << "  addi sp, sp, 16\n";
+    oss << "  ret\n";
+
     return oss.str();
 }
 
@@ -74,7 +134,7 @@ std::string visit_function(const std::unique_ptr<Function> &func) {
     std::ostringstream oss;
 
     // entry of the function
-    oss <<  func->get_func_name() << ":\n";
+    oss <<  func->get_func_name() << (func->memo_table_size > 0 ? "_memo_body" : "") << ":\n";
     current_func_param_count = func->get_param_count();
 
     // calculate the stack size that needs to be allocated
@@ -84,8 +144,17 @@ std::string visit_function(const std::unique_ptr<Function> &func) {
     local_var_count = func->local_var_count;
     // 3. space for calling other functions when its parameter count is more than 8
     //std::cout << "visiting function, calculating the extra space needed for calling other functions.\n";
+    boolean_values.clear();
+    // names that also get a value other than a comparison result
+    std::unordered_set<std::string> other_defs;
     for (const auto &bb: func->bbs) {
         for (const auto &inst : bb->insts) {
+            auto *bin = dynamic_cast<BinaryValue*>(inst.get());
+            if (bin && is_compare(bin->op)) {
+                boolean_values.insert(bin->name);
+            } else if (inst->v_tag != IRValueTag::ALLOC && !get_def(inst.get()).empty()) {
+                other_defs.insert(get_def(inst.get()));
+            }
             if (inst->v_tag == IRValueTag::CALL) {
                 if_call_other_functions = 1;
                 auto *call_value = dynamic_cast<CallValue*>(inst.get());
@@ -95,6 +164,9 @@ std::string visit_function(const std::unique_ptr<Function> &func) {
             }
         }
     }
+    for (const auto &name : other_defs) {
+        boolean_values.erase(name);
+    }
     // 4. ra if this function calls other functions
     ra_space = (if_call_other_functions == 1) ? 4 : 0;
     int extra_param_count_for_calling = std::max(0, max_calling_param_count - 8);
@@ -161,9 +233,11 @@ std::string visit_function(const std::unique_ptr<Function> &func) {
 
     // visit basic blocks
     // epilogue is done in return instruction
-    for (const auto &bb : func->bbs) {
-        oss << visit_basic_block(std::move(bb)) << "\n";
+    for (size_t i = 0; i < func->bbs.size(); i++) {
+        fallthrough_block = i + 1 < func->bbs.size() ? func->bbs[i + 1]->name : "";
+        oss << visit_basic_block(func->bbs[i]) << "\n";
     }
+    fallthrough_block.clear();
 
     return oss.str();
 }
@@ -176,7 +250,13 @@ std::string visit_basic_block(const std::unique_ptr<BasicBlock> &bb) {
         oss << bb->get_name()  << ":\n";
     }
 
-    for (const auto &inst : bb->insts) {
+    for (size_t i = 0; i < bb->insts.size(); ++i) {
+        const auto &inst = bb->insts[i];
+        if (i + 1 < bb->insts.size() && is_tail_call(inst.get(), bb->insts[i + 1].get())) {
+            // the return is done by the callee
+            oss << visit_tail_call_value(dynamic_cast<CallValue*>(inst.get())) << "\n";
+            break;
+        }
         oss << visit_value(std::move(inst)) << "\n";
     }
 
@@ -264,6 +344,107 @@ std::string visit_load_value(const LoadValue* value) {
     return oss.str();
 }
 
+static bool fits_imm12(long long c) {
+    return c >= -2048 && c < 2048;
+}
+
+// emit `t2 = t0 op c` (or `t2 = c op t0` if const_lhs) with I-type instructions,
+// returns false if the register-register form should be used instead.
+static bool select_imm_binary(std::ostringstream &oss, BinaryOp op, int c, bool const_lhs, bool boolean_operand) {
+    if (const_lhs) {
+        // c op x == x op' c
+        switch (op) {
+            case BinaryOp::ADD: case BinaryOp::AND: case BinaryOp::OR: case BinaryOp::XOR:
+            case BinaryOp::EQ: case BinaryOp::NE:
+                break;
+            case BinaryOp::LT: op = BinaryOp::GT; break;
+            case BinaryOp::GT: op = BinaryOp::LT; break;
+            case BinaryOp::LE: op = BinaryOp::GE; break;
+            case BinaryOp::GE: op = BinaryOp::LE; break;
+            case BinaryOp::SUB:
+                if (c == 0) {
+                    oss << "  neg t2, t0\n";
+                    return true;
+                }
+                return false;
+            default:
+                return false;
+        }
+    }
+
+    switch (op) {
+        case BinaryOp::ADD:
+            if (!fits_imm12(c)) return false;
+            oss << "  addi t2, t0, " << c << "\n";
+            return true;
+        case BinaryOp::SUB:
+            if (!fits_imm12(-(long long)c)) return false;
+            oss << "  addi t2, t0, " << -c << "\n";
+            return true;
+        case BinaryOp::AND:
+            if (!fits_imm12(c)) return false;
+            oss << "  andi t2, t0, " << c << "\n";
+            return true;
+        case BinaryOp::OR:
+            if (!fits_imm12(c)) return false;
+            oss << "  ori t2, t0, " << c << "\n";
+            return true;
+        case BinaryOp::XOR:
+            if (!fits_imm12(c)) return false;
+            oss << "  xori t2, t0, " << c << "\n";
+            return true;
+        case BinaryOp::SHL:
+            oss << "  slli t2, t0, " << (c & 31) << "\n";
+            return true;
+        case BinaryOp::SHR:
+            oss << "  srli t2, t0, " << (c & 31) << "\n";
+            return true;
+        case BinaryOp::SAR:
+            oss << "  srai t2, t0, " << (c & 31) << "\n";
+            return true;
+        case BinaryOp::EQ:
+        case BinaryOp::NE: {
+            const char *set = op == BinaryOp::EQ ? "seqz" : "snez";
+            if (c == 0) {
+                if (op == BinaryOp::EQ && boolean_operand) {
+                    oss << "  xori t2, t0, 1\n"; // logical not of a 0/1 value
+                } else {
+                    oss << "  " << set << " t2, t0\n";
+                }
+                return true;
+            }
+            if (!fits_imm12(c)) return false;
+            oss << "  xori t2, t0, " << c << "\n";
+            oss << "  " << set << " t2, t2\n";
+            return true;
+        }
+        case BinaryOp::LT:
+            // x < c
+            if (!fits_imm12(c)) return false;
+            oss << "  slti t2, t0, " << c << "\n";
+            return true;
+        case BinaryOp::GE:
+            // !(x < c)
+            if (!fits_imm12(c)) return false;
+            oss << "  slti t2, t0, " << c << "\n";
+            oss << "  xori t2, t2, 1\n";
+            return true;
+        case BinaryOp::LE:
+            // x < c + 1
+            if (!fits_imm12((long long)c + 1)) return false;
+            oss << "  slti t2, t0, " << c + 1 << "\n";
+            return true;
+        case BinaryOp::GT:
+            // !(x < c + 1)
+            if (!fits_imm12((long long)c + 1)) return false;
+            oss << "  slti t2, t0, " << c + 1 << "\n";
+            oss << "  xori t2, t2, 1\n";
+            return true;
+        default:
+            return false;
+    }
+}
+
 std::string visit_binary_value(const  BinaryValue* value) {
     std::ostringstream oss;
 
@@ -273,6 +454,45 @@ std::string visit_binary_value(const  BinaryValue* value) {
 
     Position t0 = Position("t0");
     Position t1 = Position("t1");
+    Position t2 = Position("t2");
+
+    // multiply/divide/modulo by a constant: try a cheaper shift/add or magic-number sequence
+    auto lhs_int = dynamic_cast<const IntergerValue*>(value->lhs.get());
+    auto rhs_int = dynamic_cast<const IntergerValue*>(value->rhs.get());
+    if (rhs_int || (lhs_int && value->op == BinaryOp::MUL)) {
+        std::ostringstream lowered;
+        const Position &src_index = rhs_int ? lhs_index : rhs_index;
+        int c = rhs_int ? rhs_int->value : lhs_int->value;
+        lowered << move(src_index, t0) << "\n";
+        bool done = false;
+        if (value->op == BinaryOp::MUL) {
+            done = lower_mul_const(lowered, "t0", "t2", c);
+        } else if (value->op == BinaryOp::DIV) {
+            done = lower_div_const(lowered, "t0", "t2", c);
+        } else if (value->op == BinaryOp::MOD) {
+            done = lower_rem_const(lowered, "t0", "t2", c);
+        }
+        if (done) {
+            oss << lowered.str();
+            oss << move(t2, result_index) << "\n";
+            return oss.str();
+        }
+    }
+
+    // one constant operand: use the I-type form of the instruction when it fits
+    if ((lhs_int != nullptr) != (rhs_int != nullptr)) {
+        std::ostringstream selected;
+        const IRValue *operand = rhs_int ? value->lhs.get() : value->rhs.get();
+        const Position &src_index = rhs_int ? lhs_index : rhs_index;
+        int c = rhs_int ? rhs_int->value : lhs_int->value;
+        selected << move(src_index, t0) << "\n";
+        if (select_imm_binary(selected, value->op, c, rhs_int == nullptr, boolean_values.count(operand->name) != 0)) {
+            oss << selected.str();
+            oss << move(t2, result_index) << "\n";
+            return oss.str();
+        }
+    }
+
     oss << move(lhs_index, t0) << "\n"; // load lhs into t0
     oss << move(rhs_index, t1) << "\n"; // load rhs into t1
     if (value->op == BinaryOp::ADD) {
@@ -313,12 +533,25 @@ std::string visit_binary_value(const  BinaryValue* value) {
         oss << "  srl t2, t0, t1\n";
     } else if (value->op == BinaryOp::SAR) {
         oss << "  sra t2, t0, t1\n";
+    } else if (value->op == BinaryOp::CZERO_EQZ || value->op == BinaryOp::CZERO_NEZ) {
+        bool eqz = value->op == BinaryOp::CZERO_EQZ;
+        if (target_has_zicond) {
+            oss << "  " << (eqz ? "czero.eqz" : "czero.nez") << " t2, t0, t1\n";
+        } else {
+            // mask of ones where lhs is kept
+            if (boolean_values.count(value->rhs->name)) {
+                oss << (eqz ? "  neg t2, t1\n" : "  addi t2, t1, -1\n");
+            } else {
+                oss << (eqz ? "  snez t2, t1\n" : "  seqz t2, t1\n");
+                oss << "  neg t2, t2\n";
+            }
+            oss << "  and t2, t0, t2\n";
+        }
     } else {
         throw std::runtime_error("Unknown binary operation");
     }
 
     //oss << "  sw t2, " << result_index;
-    Position t2 = Position("t2");
     oss << move(t2, result_index) << "\n"; // store result in result_index
     return oss.str();
 }
@@ -373,6 +606,37 @@ std::string visit_call_value(const CallValue* value) {
     return oss.str();
 }
 
+bool is_tail_call(const IRValue* inst, const IRValue* next) {
+    auto *call = dynamic_cast<const CallValue*>(inst);
+    auto *ret = dynamic_cast<const ReturnValue*>(next);
+    if (!call || !ret) {
+        return false;
+    }
+    // arguments passed on the stack would live in our frame, which is released before the jump
+    if (call->args.size() > 8) {
+        return false;
+    }
+    return ret->value == nullptr || (!call->name.empty() && ret->value->name == call->name);
+}
+
+std::string visit_tail_call_value(const CallValue* value) {
+    std::ostringstream oss;
+
+    // prepare arguments, all in a0-a7
+    for (size_t i = 0; i < value->args.size(); ++i) {
+        Position arg_index = get_local_var_index(value->args[i]->name);
+        Position a_i("a" + std::to_string(i));
+        oss << move(arg_index, a_i) << "\n";
+    }
+
+    // release our frame, then jump to the callee, which returns to our caller.
+    // ra still holds our return address, every call restores it right after returning.
+    oss << visit_epilogue();
+    oss << "  tail " << value->get_callee() << "\n";
+
+    return oss.str();
+}
+
 std::string visit_return_value(const ReturnValue* value) {
     std::ostringstream oss;
 
@@ -389,6 +653,15 @@ std::string visit_return_value(const ReturnValue* value) {
         oss << move(return_value_index, a0) << "\n"; // move return value to a0
     }
 
+    oss << visit_epilogue();
+    oss << "  ret\n"; // return from function
+
+    return oss.str();
+}
+
+std::string visit_epilogue() {
+    std::ostringstream oss;
+
     for (int i = 0; i < 12; ++i) {
         Position s_i("s" + std::to_string(i));
         Position s_i_mem(stack_size - 4 * (i + 1 + (if_call_other_functions ? 1 : 0))); // s0-s11 are saved in the stack
@@ -402,8 +675,6 @@ std::string visit_return_value(const ReturnValue* value) {
             << "  add sp, sp, t6\n"; // adjust stack pointer
     }
 
-    oss << "  ret\n"; // return from function
-
     return oss.str();
 }
 
@@ -414,8 +685,14 @@ std::string visit_branch_value(const BranchValue* value) {
     Position cond_index = get_local_var_index(value->cond->name);
     Position t0("t0");
     oss << move(cond_index, t0) << "\n"; // move condition to t0
-    oss << "  beqz t0, " << value->false_block.substr(1) << "\n"; // if condition is zero, branch to false block
-    oss << "  j " << value->true_block.substr(1) << "\n"; // otherwise, jump to true block
+    if (value->false_block == fallthrough_block) {
+        oss << "  bnez t0, " << value->true_block.substr(1) << "\n"; // fall through to the false block
+    } else {
+        oss << "  beqz t0, " << value->false_block.substr(1) << "\n"; // if condition is zero, branch to false block
+        if (value->true_block != fallthrough_block) {
+            oss << "  j " << value->true_block.substr(1) << "\n"; // otherwise, jump to true block
+        }
+    }
 
     return oss.str();
 }
@@ -423,7 +700,9 @@ std::string visit_branch_value(const BranchValue* value) {
 std::string visit_jump_value(const JumpValue* value) {
     std::ostringstream oss;
 
-    oss << "  j " << value->target_block.substr(1) << "\n"; // jump to target block
+    if (value->target_block != fallthrough_block) {
+        oss << "  j " << value->target_block.substr(1) << "\n"; // jump to target block
+    }
 
     return oss.str();
 }
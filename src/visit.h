@@ -8,6 +8,9 @@ std::string visit_program(std::unique_ptr<Program> program);
 
 std::string visit_function(const std::unique_ptr<Function> &function);
 
+// entry of a memoized function: looks the argument up in its memo table before running the body
+std::string visit_memo_wrapper(const Function * function);
+
 std::string visit_basic_block(const std::unique_ptr<BasicBlock> &basic_block);
 
 std::string visit_value(const std::unique_ptr<IRValue> &value);
@@ -24,6 +27,14 @@ std::string visit_call_value(const CallValue * call_value);
 
 std::string visit_return_value(const ReturnValue * return_value);
 
+// restore s0-s11 and release the stack frame
+std::string visit_epilogue();
+
+// a call immediately followed by a return of its result
+bool is_tail_call(const IRValue * inst, const IRValue * next);
+
+std::string visit_tail_call_value(const CallValue * call_value);
+
 std::string visit_branch_value(const BranchValue * branch_value);
 
 std::string visit_jump_value(const JumpValue * jump_value);